@@ -1,29 +1,44 @@
-QT += core gui widgets
-
-CONFIG += c++11
-
-TARGET = MenuWidget
-TEMPLATE = app
-
-SOURCES += \
-    main.cpp \
-    src/MainWindow.cpp \
-    src/widgets/MainWidget.cpp \
-    src/widgets/CustomWidget.cpp \
-    src/widgets/MenuWidget.cpp \
-    src/widgets/Container.cpp
-
-HEADERS += \
-    src/MainWindow.h \
-    src/widgets/MainWidget.h \
-    src/widgets/CustomWidget.h \
-    src/widgets/MenuWidget.h \
-    src/widgets/Container.h
-
-FORMS += \
-    src/ui/MainWidget.ui
-
-# Default rules for deployment
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+TEMPLATE = subdirs
+
+# The widget core is a static library, linked by the app, the tests, the
+# benchmarks and the tools
+SUBDIRS += \
+    core \
+    app \
+    corebenchmark \
+    navreplay \
+    menuc \
+    areastyle \
+    areaswitch \
+    menuload \
+    menusearch \
+    menustore
+
+core.file = src/core.pro
+
+app.file = app/app.pro
+app.depends = core
+
+corebenchmark.subdir = tests/corebenchmark
+corebenchmark.depends = core
+
+navreplay.subdir = tools/navreplay
+navreplay.depends = core
+
+menuc.subdir = tools/menuc
+menuc.depends = core
+
+areastyle.subdir = benchmarks/areastyle
+areastyle.depends = core
+
+areaswitch.subdir = benchmarks/areaswitch
+areaswitch.depends = core
+
+menuload.subdir = benchmarks/menuload
+menuload.depends = core
+
+menusearch.subdir = benchmarks/menusearch
+menusearch.depends = core
+
+menustore.subdir = benchmarks/menustore
+menustore.depends = core
@@ -58,14 +58,19 @@ void MainWindow::onUserClickedRenameButton() {
 // 4. Batch rename from database/config
 // ========================================
 
+// Collect all names first and apply them with one renameTabs() call:
+// every bar is updated in one pass and only the renamed tabs are
+// repainted, instead of one relayout and repaint per call.
+// An item index of -1 renames the category itself.
+
 void MainWindow::loadTabNamesFromDatabase() {
+    QVector<MenuWidget::TabTextChange> changes;
+
     // Example: Load from database
     QMap<int, QString> categoryNames = database->getCategoryNames();
 
     for (auto it = categoryNames.begin(); it != categoryNames.end(); ++it) {
-        int index = it.key();
-        QString name = it.value();
-        renameCategory(index, name);
+        changes.append(MenuWidget::TabTextChange(it.key(), -1, it.value()));
     }
 
     // Load item names
@@ -73,11 +78,11 @@ void MainWindow::loadTabNamesFromDatabase() {
         QMap<int, QString> itemNames = database->getItemNames(categoryIndex);
 
         for (auto it = itemNames.begin(); it != itemNames.end(); ++it) {
-            int itemIndex = it.key();
-            QString itemName = it.value();
-            renameItem(categoryIndex, itemIndex, itemName);
+            changes.append(MenuWidget::TabTextChange(categoryIndex, it.key(), it.value()));
         }
     }
+
+    renameTabs(changes);
 }
 
 // ========================================
@@ -145,6 +150,7 @@ void MainWindow::setupMenuWidget() {
  * 2. Public wrapper methods in MainWindow:
  *    - renameCategory(index, name)
  *    - renameItem(categoryIndex, itemIndex, name)
+ *    - renameTabs(changes)
  *
  * 3. Benefits:
  *    - Clear, simple API for external use
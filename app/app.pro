@@ -0,0 +1,18 @@
+CONFIG += c++11
+
+TARGET = MenuWidget
+TEMPLATE = app
+
+include(../src/core.pri)
+
+SOURCES += \
+    ../main.cpp \
+    ../src/MainWindow.cpp
+
+HEADERS += \
+    ../src/MainWindow.h
+
+# Default rules for deployment
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
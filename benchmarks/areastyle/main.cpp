@@ -0,0 +1,191 @@
+// ========================================
+// BENCHMARK: styling the active area on every switch
+// ========================================
+// A shown window with a grid of areas (4 by default), each bordered and
+// holding a page of content widgets, and one label per area above them.
+// Every switch marks a new area active and the previous one inactive,
+// the way MainWidget::switchToArea does, then lets Qt process the
+// resulting polish, layout and paint events.
+//
+//   stylesheet  - the old path: stylesheet borders on the area frames
+//                 (cascading to all content) and setStyleSheet() on the
+//                 two labels at each switch
+//   palette     - BorderFrame borders, precomputed QPalette and QFont
+//                 set on the two labels
+//
+// Also measures recoloring every area at once (a theme change).
+//
+// Run headless:
+//   QT_QPA_PLATFORM=offscreen ./areastyle_benchmark [switches] [areas] [widgets per area]
+// ========================================
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <QVector>
+#include "BorderFrame.h"
+#include "CustomWidget.h"
+
+static const char *const Colors[] = { "red", "blue", "darkorange", "purple", "teal", "brown" };
+static const char *const ThemeColors[] = { "crimson", "navy", "goldenrod", "indigo", "seagreen", "sienna" };
+static const int ColorCount = int(sizeof(Colors) / sizeof(Colors[0]));
+
+static void report(const char *name, qint64 elapsedNs, int repetitions)
+{
+    QTextStream out(stdout);
+    out << QString(name).leftJustified(24)
+        << double(elapsedNs) / repetitions / 1000 << " us\n";
+}
+
+// Let Qt do the work the restyle scheduled: polish, layout, paint
+static void flushEvents()
+{
+    QCoreApplication::sendPostedEvents();
+    QCoreApplication::processEvents();
+}
+
+struct Areas {
+    QWidget window;
+    QVector<QWidget*> frames;
+    QVector<QLabel*> labels;
+};
+
+static void setupAreas(Areas &areas, bool painted, int areaCount, int widgetsPerArea)
+{
+    QVBoxLayout *layout = new QVBoxLayout(&areas.window);
+    QHBoxLayout *labelLayout = new QHBoxLayout();
+    QGridLayout *grid = new QGridLayout();
+    layout->addLayout(labelLayout);
+    layout->addLayout(grid);
+
+    const int columns = areaCount > 1 ? 2 : 1;
+    for (int i = 0; i < areaCount; ++i) {
+        QWidget *frame;
+        if (painted) {
+            BorderFrame *borderFrame = new BorderFrame(&areas.window);
+            borderFrame->setBorderColor(QColor(Colors[i % ColorCount]));
+            frame = borderFrame;
+        } else {
+            frame = new QWidget(&areas.window);
+            frame->setStyleSheet(QString("border: 2px solid %1;").arg(QLatin1String(Colors[i % ColorCount])));
+        }
+
+        QVBoxLayout *frameLayout = new QVBoxLayout(frame);
+        for (int j = 0; j < widgetsPerArea; ++j) {
+            frameLayout->addWidget(new CustomWidget(QString("Content %1.%2").arg(i).arg(j)));
+        }
+        grid->addWidget(frame, i / columns, i % columns);
+        areas.frames.append(frame);
+
+        QLabel *label = new QLabel(QString("Area %1:").arg(i + 1), &areas.window);
+        labelLayout->addWidget(label);
+        areas.labels.append(label);
+    }
+
+    areas.window.resize(1200, 900);
+    areas.window.show();
+    flushEvents();
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    const int switches = argc > 1 ? QString(argv[1]).toInt() : 1000;
+    const int areaCount = argc > 2 ? qMax(2, QString(argv[2]).toInt()) : 4;
+    const int widgetsPerArea = argc > 3 ? QString(argv[3]).toInt() : 50;
+    const int themeChanges = 20;
+
+    QElapsedTimer timer;
+    qint64 stylesheetElapsed = 0;
+    qint64 paletteElapsed = 0;
+
+    // ========================================
+    // Old path: stylesheets
+    // ========================================
+    {
+        Areas areas;
+        setupAreas(areas, false, areaCount, widgetsPerArea);
+
+        int current = 0;
+        timer.start();
+        for (int i = 0; i < switches; ++i) {
+            int next = (current + 1) % areaCount;
+            areas.labels.at(current)->setText(QString("Area %1:").arg(current + 1));
+            areas.labels.at(current)->setStyleSheet("");
+            areas.labels.at(next)->setText(QString("Area %1: [ACTIVE]").arg(next + 1));
+            areas.labels.at(next)->setStyleSheet(QString("font-weight: bold; color: %1;").arg(QLatin1String(Colors[next % ColorCount])));
+            current = next;
+            flushEvents();
+        }
+        stylesheetElapsed = timer.nsecsElapsed();
+        report("stylesheet switch", stylesheetElapsed, switches);
+
+        timer.start();
+        for (int i = 0; i < themeChanges; ++i) {
+            const char *const *colors = i % 2 ? Colors : ThemeColors;
+            for (int j = 0; j < areaCount; ++j) {
+                areas.frames.at(j)->setStyleSheet(QString("border: 2px solid %1;").arg(QLatin1String(colors[j % ColorCount])));
+            }
+            flushEvents();
+        }
+        report("stylesheet theme", timer.nsecsElapsed(), themeChanges);
+    }
+
+    // ========================================
+    // Painted borders, precomputed palettes and font
+    // ========================================
+    {
+        Areas areas;
+        setupAreas(areas, true, areaCount, widgetsPerArea);
+
+        QFont activeFont = areas.window.font();
+        activeFont.setBold(true);
+        QVector<QPalette> activePalettes;
+        for (int j = 0; j < areaCount; ++j) {
+            QPalette palette = areas.window.palette();
+            palette.setColor(QPalette::WindowText, QColor(Colors[j % ColorCount]));
+            activePalettes.append(palette);
+        }
+
+        int current = 0;
+        timer.start();
+        for (int i = 0; i < switches; ++i) {
+            int next = (current + 1) % areaCount;
+            areas.labels.at(current)->setText(QString("Area %1:").arg(current + 1));
+            areas.labels.at(current)->setPalette(QPalette());
+            areas.labels.at(current)->setFont(QFont());
+            areas.labels.at(next)->setText(QString("Area %1: [ACTIVE]").arg(next + 1));
+            areas.labels.at(next)->setPalette(activePalettes.at(next));
+            areas.labels.at(next)->setFont(activeFont);
+            current = next;
+            flushEvents();
+        }
+        paletteElapsed = timer.nsecsElapsed();
+        report("palette switch", paletteElapsed, switches);
+
+        timer.start();
+        for (int i = 0; i < themeChanges; ++i) {
+            const char *const *colors = i % 2 ? Colors : ThemeColors;
+            for (int j = 0; j < areaCount; ++j) {
+                static_cast<BorderFrame*>(areas.frames.at(j))->setBorderColor(QColor(colors[j % ColorCount]));
+            }
+            flushEvents();
+        }
+        report("palette theme", timer.nsecsElapsed(), themeChanges);
+    }
+
+    if (paletteElapsed > 0) {
+        QTextStream(stdout) << "switch speedup: " << double(stylesheetElapsed) / paletteElapsed << "x\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,10 @@
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = areaswitch_benchmark
+TEMPLATE = app
+
+include(../../src/core.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,155 @@
+// ========================================
+// BENCHMARK: moving content widgets between areas
+// ========================================
+// Two areas (Containers) side by side in a shown window, each already
+// holding some content widgets. Every switch moves one widget to the
+// other area and shows it, the way MainWidget::updateAreaDisplay does,
+// then lets Qt process the resulting layout and polish events.
+//
+//   detach/attach  - the old path: scan the other area's widget list,
+//                    detach() (parentless hop), setParent(), attach()
+//   registry       - ContainerRegistry lookup and moveTo()
+//
+// Run headless:
+//   QT_QPA_PLATFORM=offscreen ./areaswitch_benchmark [switches] [widgets per area]
+// ========================================
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QHBoxLayout>
+#include <QTextStream>
+#include <QVector>
+#include "Container.h"
+#include "ContainerRegistry.h"
+#include "CustomWidget.h"
+
+static void report(const char *name, qint64 elapsedNs, int switches)
+{
+    QTextStream out(stdout);
+    out << QString(name).leftJustified(20)
+        << double(elapsedNs) / switches / 1000 << " us per switch\n";
+}
+
+// Let Qt do the work the move scheduled: layout requests, polish, etc.
+static void flushEvents()
+{
+    QCoreApplication::sendPostedEvents();
+    QCoreApplication::processEvents();
+}
+
+struct Areas {
+    QWidget window;
+    Container *areas[2];
+    QVector<CustomWidget*> widgets;
+    QVector<int> sides;     // Area each widget is in
+};
+
+static void setupAreas(Areas &areas, int widgetsPerArea)
+{
+    QHBoxLayout *layout = new QHBoxLayout(&areas.window);
+    for (int i = 0; i < 2; ++i) {
+        areas.areas[i] = new Container(&areas.window);
+        layout->addWidget(areas.areas[i]);
+    }
+
+    for (int i = 0; i < 2 * widgetsPerArea; ++i) {
+        areas.widgets.append(new CustomWidget(QString("Content %1").arg(i)));
+        areas.sides.append(i % 2);
+    }
+
+    areas.window.resize(900, 600);
+    areas.window.show();
+    flushEvents();
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    const int switches = argc > 1 ? QString(argv[1]).toInt() : 2000;
+    const int widgetsPerArea = argc > 2 ? QString(argv[2]).toInt() : 200;
+
+    QElapsedTimer timer;
+    qint64 oldElapsed = 0;
+    qint64 registryElapsed = 0;
+
+    // ========================================
+    // Old path: detach, parentless, reparent, attach
+    // ========================================
+    {
+        Areas areas;
+        setupAreas(areas, widgetsPerArea);
+
+        for (int i = 0; i < areas.widgets.size(); ++i) {
+            CustomWidget *widget = areas.widgets.at(i);
+            widget->setParent(areas.areas[i % 2]);
+            areas.areas[i % 2]->attach(widget);
+        }
+        flushEvents();
+
+        timer.start();
+        for (int i = 0; i < switches; ++i) {
+            int index = i % areas.widgets.size();
+            CustomWidget *widget = areas.widgets.at(index);
+            Container *other = areas.areas[areas.sides.at(index)];
+            areas.sides[index] ^= 1;
+            Container *target = areas.areas[areas.sides.at(index)];
+
+            if (other->getWidgets().contains(widget)) {
+                other->detach(widget);
+            }
+            widget->setParent(target);
+            if (!target->getWidgets().contains(widget)) {
+                target->attach(widget);
+            }
+            target->show(widget);
+            flushEvents();
+        }
+        oldElapsed = timer.nsecsElapsed();
+        report("detach/attach", oldElapsed, switches);
+
+        qDeleteAll(areas.widgets);
+    }
+
+    // ========================================
+    // Registry: one lookup, one container-to-container reparent
+    // ========================================
+    {
+        Areas areas;
+        setupAreas(areas, widgetsPerArea);
+
+        ContainerRegistry registry;
+        for (int i = 0; i < areas.widgets.size(); ++i) {
+            registry.moveTo(areas.widgets.at(i), areas.areas[i % 2]);
+        }
+        flushEvents();
+
+        timer.start();
+        for (int i = 0; i < switches; ++i) {
+            int index = i % areas.widgets.size();
+            CustomWidget *widget = areas.widgets.at(index);
+            areas.sides[index] ^= 1;
+            Container *target = areas.areas[areas.sides.at(index)];
+
+            if (registry.container(widget) != target) {
+                registry.moveTo(widget, target);
+            }
+            target->show(widget);
+            flushEvents();
+        }
+        registryElapsed = timer.nsecsElapsed();
+        report("registry", registryElapsed, switches);
+
+        qDeleteAll(areas.widgets);
+    }
+
+    if (registryElapsed > 0) {
+        QTextStream(stdout) << "speedup: " << double(oldElapsed) / registryElapsed << "x\n";
+    }
+
+    return 0;
+}
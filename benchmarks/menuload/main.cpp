@@ -0,0 +1,158 @@
+// ========================================
+// BENCHMARK: time to first paint, JSON vs compiled menu
+// ========================================
+// Writes the same catalog (1000 categories x 1000 items by default) as
+// JSON and as a compiled menu, then measures for each format the time
+// from opening the file to the first rendered frame of a MenuWidget.
+//
+// Run headless:
+//   QT_QPA_PLATFORM=offscreen ./menuload_benchmark [categories] [items]
+// ========================================
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "MenuWidget.h"
+#include "CompiledMenuModel.h"
+#include "CompiledMenuWriter.h"
+
+static void report(const char *name, qint64 elapsedNs, qint64 fileSize)
+{
+    QTextStream out(stdout);
+    out << QString(name).leftJustified(28)
+        << double(elapsedNs) / 1000000 << " ms  ("
+        << fileSize / 1024 << " KiB on disk)\n";
+}
+
+// Render the menu once, as the first frame on screen would
+static void firstPaint(MenuWidget &menuWidget)
+{
+    menuWidget.resize(900, 120);
+    menuWidget.grab();
+}
+
+// Build a MenuModel from JSON the way a hand-written loader would
+static bool loadJson(const QString &fileName, MenuModel *model)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    const QJsonArray categories = document.object().value(QStringLiteral("categories")).toArray();
+
+    for (const QJsonValue &categoryValue : categories) {
+        QJsonObject categoryObject = categoryValue.toObject();
+        int category = model->appendCategory(categoryObject.value(QStringLiteral("label")).toString());
+
+        QStringList labels;
+        QList<MenuModel::ContentFactory> factories;
+        const QJsonArray items = categoryObject.value(QStringLiteral("items")).toArray();
+        for (const QJsonValue &itemValue : items) {
+            QJsonObject itemObject = itemValue.toObject();
+            QString content = itemObject.value(QStringLiteral("content")).toString();
+            labels.append(itemObject.value(QStringLiteral("label")).toString());
+            factories.append([content]() { return new CustomWidget(content); });
+        }
+        model->appendItems(category, labels, factories);
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    const int categoryCount = argc > 1 ? QString(argv[1]).toInt() : 1000;
+    const int itemCount = argc > 2 ? QString(argv[2]).toInt() : 1000;
+
+    QTemporaryDir dir;
+    QString jsonPath = dir.filePath(QStringLiteral("menu.json"));
+    QString compiledPath = dir.filePath(QStringLiteral("menu.menu"));
+
+    // ========================================
+    // Generate the catalog in both formats
+    // ========================================
+    QJsonArray categories;
+    for (int i = 0; i < categoryCount; ++i) {
+        QJsonArray items;
+        for (int j = 0; j < itemCount; ++j) {
+            QJsonObject item;
+            item.insert(QStringLiteral("label"), QString("Item %1-%2").arg(i).arg(j));
+            item.insert(QStringLiteral("content"), QString("Content for Category %1 - Item %2").arg(i).arg(j));
+            items.append(item);
+        }
+
+        QJsonObject category;
+        category.insert(QStringLiteral("label"), QString("Category %1").arg(i));
+        category.insert(QStringLiteral("items"), items);
+        categories.append(category);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("categories"), categories);
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+
+    QFile jsonFile(jsonPath);
+    if (!jsonFile.open(QIODevice::WriteOnly) || jsonFile.write(json) != json.size()) {
+        return 1;
+    }
+    jsonFile.close();
+
+    CompiledMenuWriter writer;
+    QFile compiledFile(compiledPath);
+    if (!writer.addJson(json) || !compiledFile.open(QIODevice::WriteOnly) || !writer.write(&compiledFile)) {
+        return 1;
+    }
+    compiledFile.close();
+
+    QElapsedTimer timer;
+
+    // ========================================
+    // JSON: parse, build a MenuModel, first paint
+    // ========================================
+    {
+        timer.start();
+        MenuModel *model = new MenuModel;
+        if (!loadJson(jsonPath, model)) {
+            return 1;
+        }
+        MenuWidget menuWidget;
+        menuWidget.setModel(model);
+        firstPaint(menuWidget);
+        report("JSON", timer.nsecsElapsed(), QFile(jsonPath).size());
+
+        menuWidget.setModel(nullptr);
+        delete model;
+    }
+
+    // ========================================
+    // Compiled: map, first paint
+    // ========================================
+    {
+        timer.start();
+        CompiledMenuModel model;
+        if (!model.open(compiledPath)) {
+            return 1;
+        }
+        MenuWidget menuWidget;
+        menuWidget.setModel(&model);
+        firstPaint(menuWidget);
+        report("compiled (mapped)", timer.nsecsElapsed(), QFile(compiledPath).size());
+
+        menuWidget.setModel(nullptr);
+    }
+
+    return 0;
+}
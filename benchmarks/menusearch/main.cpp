@@ -0,0 +1,156 @@
+// ========================================
+// BENCHMARK: type-ahead search over all tab labels
+// ========================================
+// Fills a MenuModel (1000 categories x 1000 items by default) with
+// labels made of common words, then measures building the SearchIndex,
+// keeping it up to date while items are appended, renamed, removed and
+// moved (and the first query after that, which must not rebuild), and the
+// time of top-10 queries: word prefixes, several words, mid-word text
+// and misspellings.
+//
+// Run:
+//   ./menusearch_benchmark [categories] [items]
+// ========================================
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include "MenuModel.h"
+#include "SearchIndex.h"
+
+static const char *const Words[] = {
+    "General", "Network", "Display", "Audio", "Storage", "Printer", "Account",
+    "Security", "Backup", "Update", "Language", "Keyboard", "Mouse", "Power",
+    "Camera", "Bluetooth", "Firewall", "Proxy", "Theme", "Fonts", "Startup",
+    "Logging", "Alerts", "Sharing", "Privacy", "Devices", "Sensors", "Calendar",
+    "Contacts", "Reports", "Scanner", "Monitor", "Schedule", "Profiles", "Licenses"
+};
+static const int WordCount = int(sizeof(Words) / sizeof(Words[0]));
+
+static QString itemLabel(int category, int item)
+{
+    return QString("%1 %2 %3")
+            .arg(QLatin1String(Words[(category * 7 + item) % WordCount]))
+            .arg(QLatin1String(Words[(item * 13 + category / 3) % WordCount]))
+            .arg(item);
+}
+
+static void report(const char *name, qint64 elapsedNs, int repetitions = 1)
+{
+    QTextStream out(stdout);
+    out << QString(name).leftJustified(36)
+        << double(elapsedNs) / repetitions / 1000 << " us\n";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int categoryCount = argc > 1 ? QString(argv[1]).toInt() : 1000;
+    const int itemCount = argc > 2 ? QString(argv[2]).toInt() : 1000;
+    const int repetitions = 200;
+
+    MenuModel model;
+    for (int i = 0; i < categoryCount; ++i) {
+        int category = model.appendCategory(QString("%1 %2").arg(QLatin1String(Words[i % WordCount])).arg(i));
+
+        QStringList labels;
+        for (int j = 0; j < itemCount; ++j) {
+            labels.append(itemLabel(i, j));
+        }
+        model.appendItems(category, labels);
+    }
+
+    QElapsedTimer timer;
+    SearchIndex index;
+    index.setModel(&model);
+
+    // ========================================
+    // Full build, done by the first search
+    // ========================================
+    timer.start();
+    index.search(QStringLiteral("x"));
+    report("build", timer.nsecsElapsed());
+
+    QTextStream(stdout) << index.count() << " labels indexed\n";
+
+    // ========================================
+    // Incremental updates
+    // ========================================
+    {
+        QStringList labels;
+        for (int j = 0; j < 1000; ++j) {
+            labels.append(itemLabel(0, itemCount + j));
+        }
+
+        timer.start();
+        model.appendItems(0, labels);
+        report("append 1000 items", timer.nsecsElapsed());
+
+        QVector<MenuModel::LabelChange> changes;
+        for (int j = 0; j < 1000; ++j) {
+            changes.append(MenuModel::LabelChange(1, j, QString("Renamed %1").arg(j)));
+        }
+
+        timer.start();
+        model.setLabels(changes);
+        report("rename 1000 items", timer.nsecsElapsed());
+
+        timer.start();
+        for (int j = 0; j < 100; ++j) {
+            model.removeItem(2, itemCount / 2);
+        }
+        report("remove 100 items", timer.nsecsElapsed());
+
+        timer.start();
+        for (int j = 0; j < 100; ++j) {
+            model.moveItem(3, 0, itemCount - 1);
+            model.moveCategory(categoryCount - 1, 4);
+        }
+        report("move 100 items, 100 categories", timer.nsecsElapsed());
+
+        timer.start();
+        for (int j = 0; j < 10; ++j) {
+            model.removeCategory(categoryCount - 1 - j);
+        }
+        report("remove 10 categories", timer.nsecsElapsed());
+
+        timer.start();
+        index.search(QStringLiteral("blue"));
+        report("first query after churn", timer.nsecsElapsed());
+    }
+
+    // ========================================
+    // Queries, top 10
+    // ========================================
+    const char *const queries[][2] = {
+        { "word prefix", "blue" },
+        { "two words", "printer sched" },
+        { "words and number", "network theme 42" },
+        { "mid-word", "wall" },
+        { "misspelled", "bluetoth" },
+        { "renamed label", "renamed 500" },
+        { "no match", "zzzzqq" }
+    };
+
+    for (const auto &query : queries) {
+        QString text = QLatin1String(query[1]);
+        QVector<SearchIndex::Match> matches;
+
+        timer.start();
+        for (int i = 0; i < repetitions; ++i) {
+            matches = index.search(text, 10);
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+
+        QByteArray name = QString("query: %1 \"%2\"").arg(QLatin1String(query[0]), text).toUtf8();
+        report(name.constData(), elapsed, repetitions);
+
+        if (!matches.isEmpty()) {
+            QTextStream(stdout) << "    best: " << matches.first().label << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+// ========================================
+// MICRO-BENCHMARK: MenuWidget item store
+// ========================================
+// Measures building (one call per item and batched), (level1, level2)
+// content lookup, level 2 selection dispatch and category switching
+// on a 10k categories x 100 items menu.
+//
+// Run headless:
+//   QT_QPA_PLATFORM=offscreen ./menustore_benchmark [categories] [items]
+// ========================================
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "MenuWidget.h"
+
+static void report(const char *name, qint64 elapsedNs, qint64 operations)
+{
+    QTextStream out(stdout);
+    out << QString(name).leftJustified(28)
+        << double(elapsedNs) / operations << " ns/op  ("
+        << operations << " ops, " << elapsedNs / 1000000 << " ms)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    const int categoryCount = argc > 1 ? QString(argv[1]).toInt() : 10000;
+    const int itemCount = argc > 2 ? QString(argv[2]).toInt() : 100;
+
+    MenuWidget menuWidget;
+    QElapsedTimer timer;
+
+    // ========================================
+    // Build: items without content, so only the store is measured
+    // ========================================
+    timer.start();
+    for (int i = 0; i < categoryCount; ++i) {
+        menuWidget.addLevel1Tab(QString("Category %1").arg(i));
+        for (int j = 0; j < itemCount; ++j) {
+            menuWidget.addLevel2Tab(i, QString("Item %1-%2").arg(i).arg(j),
+                                    static_cast<CustomWidget*>(nullptr));
+        }
+    }
+    report("build", timer.nsecsElapsed(), qint64(categoryCount) * itemCount);
+
+    // ========================================
+    // Batched build: one transaction, one insertion per category
+    // ========================================
+    {
+        MenuWidget batchedMenu;
+        timer.start();
+        batchedMenu.beginUpdate();
+        for (int i = 0; i < categoryCount; ++i) {
+            batchedMenu.addLevel1Tab(QString("Category %1").arg(i));
+
+            QStringList names;
+            names.reserve(itemCount);
+            for (int j = 0; j < itemCount; ++j) {
+                names.append(QString("Item %1-%2").arg(i).arg(j));
+            }
+            batchedMenu.addLevel2Tabs(i, names, QList<MenuWidget::ContentFactory>());
+        }
+        batchedMenu.endUpdate();
+        report("batched build", timer.nsecsElapsed(), qint64(categoryCount) * itemCount);
+    }
+
+    // ========================================
+    // Lookup: getContentWidget over every (level1, level2) pair
+    // ========================================
+    const int lookupRounds = 10;
+    quintptr sink = 0;
+    timer.start();
+    for (int round = 0; round < lookupRounds; ++round) {
+        for (int i = 0; i < categoryCount; ++i) {
+            for (int j = 0; j < itemCount; ++j) {
+                sink += reinterpret_cast<quintptr>(menuWidget.getContentWidget(i, j));
+            }
+        }
+    }
+    report("getContentWidget", timer.nsecsElapsed(),
+           qint64(lookupRounds) * categoryCount * itemCount);
+
+    // ========================================
+    // Dispatch: level 2 currentChanged -> tabSelectionChanged
+    // ========================================
+    qint64 dispatched = 0;
+    QObject::connect(&menuWidget, &MenuWidget::tabSelectionChanged,
+                     [&dispatched](int, int) { ++dispatched; });
+
+    TabStrip *level2TabStrip =
+        menuWidget.findChild<TabStrip*>(QStringLiteral("level2TabStrip"));
+
+    timer.start();
+    for (int i = 0; i < categoryCount; ++i) {
+        // Walk away from the current tab and back again
+        menuWidget.setCurrentTabs(i, 0);
+        level2TabStrip->setCurrentIndex(level2TabStrip->count() - 1);
+        level2TabStrip->setCurrentIndex(0);
+    }
+    report("selection dispatch", timer.nsecsElapsed(), qMax<qint64>(1, dispatched));
+
+    // ========================================
+    // Category switch: re-rooting the shared level 2 strip
+    // ========================================
+    timer.start();
+    for (int i = 0; i < categoryCount; ++i) {
+        menuWidget.setCurrentTabs(i, itemCount - 1);
+        sink += level2TabStrip->scrollOffset();
+    }
+    report("category switch", timer.nsecsElapsed(), categoryCount);
+
+    return sink == 1 ? 1 : 0;
+}
@@ -1,12 +1,64 @@
 #include <QApplication>
 #include "src/MainWindow.h"
+#include "src/trace/Trace.h"
+#include "src/trace/StartupTimer.h"
 
 int main(int argc, char *argv[])
 {
+    // First, so it measures everything that follows
+    StartupTimer startupTimer;
+
     QApplication app(argc, argv);
 
-    MainWindow mainWindow;
+    // MENUWIDGET_TRACE=<file> records a Chrome trace, written on exit
+    QString traceFile = qEnvironmentVariable("MENUWIDGET_TRACE");
+    if (!traceFile.isEmpty()) {
+        Trace::setEnabled(true);
+    }
+
+    // MENUWIDGET_STARTUP=deferred paints the window with the first category
+    // and fills in the rest of the menu afterwards
+    MainWindow::StartupMode startupMode = MainWindow::ImmediateStartup;
+    if (qEnvironmentVariable("MENUWIDGET_STARTUP") == QLatin1String("deferred")) {
+        startupMode = MainWindow::DeferredStartup;
+    }
+
+    MainWindow mainWindow(nullptr, startupMode);
+
+    // MENUWIDGET_RECORD=<file> logs the session's navigation for tools/navreplay
+    QString recordFile = qEnvironmentVariable("MENUWIDGET_RECORD");
+    if (!recordFile.isEmpty()) {
+        mainWindow.recordNavigation(recordFile);
+    }
+
+    // Optional menu file (.menu, .json or .xml) replacing the demo menu
+    if (app.arguments().size() > 1) {
+        mainWindow.loadMenu(app.arguments().at(1));
+    }
+
+    // Interactive once the menu is complete and the event loop is free
+    startupTimer.watchFirstPaint(&mainWindow);
+    if (mainWindow.isMenuPopulated()) {
+        startupTimer.markInteractive();
+    } else {
+        QObject::connect(&mainWindow, &MainWindow::menuPopulated,
+                         &startupTimer, &StartupTimer::markInteractive);
+    }
+
+    // MENUWIDGET_STARTUP_TIMES=1 prints process start -> first paint -> interactive
+    if (qEnvironmentVariableIsSet("MENUWIDGET_STARTUP_TIMES")) {
+        QObject::connect(&startupTimer, &StartupTimer::finished, [&startupTimer]() {
+            qInfo("%s", qPrintable(startupTimer.report()));
+        });
+    }
+
     mainWindow.show();
 
-    return app.exec();
+    int result = app.exec();
+
+    if (!traceFile.isEmpty()) {
+        Trace::writeChromeTrace(traceFile);
+    }
+
+    return result;
 }
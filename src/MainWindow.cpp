@@ -2,12 +2,42 @@
 #include "widgets/MainWidget.h"
 #include "widgets/MenuWidget.h"
 #include "widgets/CustomWidget.h"
+#include "widgets/SearchPalette.h"
+#include "widgets/ContentPrefetcher.h"
+#include "widgets/NavigationRecorder.h"
+#include "model/CompiledMenuModel.h"
+#include "model/MenuModel.h"
+#include "model/MenuLoader.h"
+#include <QStatusBar>
+#include <QSettings>
+#include <QFileInfo>
+#include <QShortcut>
+#include <QTimer>
+#include <QEvent>
 
-MainWindow::MainWindow(QWidget *parent)
+// Build the CustomWidget only when its tab is first displayed
+static MenuWidget::ContentFactory lazyContent(const QString &text)
+{
+    return [text]() { return new CustomWidget(text); };
+}
+
+// Number of items of each category of the demo menu
+static const int DemoItemCounts[] = { 3, 2, 4 };
+static const int DemoCategoryCount = int(sizeof(DemoItemCounts) / sizeof(DemoItemCounts[0]));
+
+MainWindow::MainWindow(QWidget *parent, StartupMode startupMode)
     : QMainWindow(parent)
     , m_mainWidget(nullptr)
     , m_menuWidget(nullptr)
+    , m_startupMode(startupMode)
+    , m_menuPopulated(false)
+    , m_nextDemoCategory(0)
+    , m_recorder(nullptr)
 {
+    m_populateTimer = new QTimer(this);
+    m_populateTimer->setInterval(0);
+    connect(m_populateTimer, &QTimer::timeout, this, &MainWindow::populateNextDemoCategory);
+
     // Create MainWidget
     m_mainWidget = new MainWidget(this);
     setCentralWidget(m_mainWidget);
@@ -22,6 +52,106 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    saveSession();
+
+    if (m_recorder) {
+        QString errorString;
+        if (!m_recorder->save(m_recordFile, &errorString)) {
+            qWarning("Cannot save navigation log %s: %s", qPrintable(m_recordFile), qPrintable(errorString));
+        }
+    }
+}
+
+void MainWindow::renameCategory(int categoryIndex, const QString &newName)
+{
+    m_menuWidget->setLevel1TabText(categoryIndex, newName);
+}
+
+void MainWindow::renameItem(int categoryIndex, int itemIndex, const QString &newName)
+{
+    m_menuWidget->setLevel2TabText(categoryIndex, itemIndex, newName);
+}
+
+void MainWindow::renameTabs(const QVector<MenuWidget::TabTextChange> &changes)
+{
+    m_menuWidget->setTabTexts(changes);
+}
+
+bool MainWindow::loadMenu(const QString &fileName)
+{
+    if (!fileName.endsWith(QLatin1String(".menu"), Qt::CaseInsensitive)) {
+        stopDemoPopulation();
+        loadMenuDefinition(fileName);
+        return true;
+    }
+
+    // Labels are read straight from the mapped file, nothing is built up front
+    CompiledMenuModel *model = new CompiledMenuModel(m_menuWidget);
+    if (!model->open(fileName)) {
+        qWarning("Cannot load menu %s: %s", qPrintable(fileName), qPrintable(model->errorString()));
+        delete model;
+        return false;
+    }
+
+    stopDemoPopulation();
+
+    // Owned by the menu widget, which drops it when another catalog is set
+    m_menuWidget->setModel(model);
+    m_menuFile = QFileInfo(fileName).absoluteFilePath();
+
+    // Show where the last session left this catalog, or the defaults
+    if (!restoreSession()) {
+        m_mainWidget->initializeAreas();
+    }
+    setMenuPopulated();
+    return true;
+}
+
+void MainWindow::recordNavigation(const QString &fileName)
+{
+    if (!m_recorder) {
+        m_recorder = new NavigationRecorder(this);
+        m_recorder->setMenuWidget(m_menuWidget);
+        m_recorder->setMainWidget(m_mainWidget);
+    }
+
+    m_recordFile = fileName;
+    m_recorder->clear();
+    m_recorder->start();
+}
+
+void MainWindow::loadMenuDefinition(const QString &fileName)
+{
+    // Start from an empty model that fills in while the window stays live
+    MenuModel *model = new MenuModel(m_menuWidget);
+    m_menuWidget->setModel(model);
+    m_menuFile = QFileInfo(fileName).absoluteFilePath();
+
+    // Dies with the model, so replacing the catalog also stops its load
+    MenuLoader *loader = new MenuLoader(model, model);
+
+    connect(loader, &MenuLoader::categoryLoaded, this, [this](int category) {
+        // The first category delivered is the one on screen
+        if (category == 0) {
+            m_mainWidget->initializeAreas();
+        }
+    });
+    connect(loader, &MenuLoader::progress, this, [this](int loaded, int total) {
+        statusBar()->showMessage(tr("Loading menu: %1 of %2 categories").arg(loaded).arg(total));
+    });
+    connect(loader, &MenuLoader::finished, this, [this]() {
+        statusBar()->showMessage(tr("Menu loaded"), 2000);
+
+        // Saved positions may lie anywhere in the catalog
+        restoreSession();
+        setMenuPopulated();
+    });
+    connect(loader, &MenuLoader::failed, this, [this, fileName](const QString &errorString) {
+        qWarning("Cannot load menu %s: %s", qPrintable(fileName), qPrintable(errorString));
+        statusBar()->clearMessage();
+    });
+
+    loader->load(fileName);
 }
 
 void MainWindow::setupMenuWidget()
@@ -29,29 +159,110 @@ void MainWindow::setupMenuWidget()
     // Create MenuWidget
     m_menuWidget = new MenuWidget(this);
 
-    // Add level 1 tabs
-    m_menuWidget->addLevel1Tab("Category 1");
-    m_menuWidget->addLevel1Tab("Category 2");
-    m_menuWidget->addLevel1Tab("Category 3");
+    // Build the first category, or the whole menu, in one pass
+    int immediateCategories = m_startupMode == DeferredStartup ? 1 : DemoCategoryCount;
+    m_menuWidget->beginUpdate();
+    for (m_nextDemoCategory = 0; m_nextDemoCategory < immediateCategories; ++m_nextDemoCategory) {
+        addDemoCategory(m_nextDemoCategory);
+    }
+    m_menuWidget->endUpdate();
 
-    // Add level 2 tabs for Category 1 (index 0)
-    m_menuWidget->addLevel2Tab(0, "Item 1-1", new CustomWidget("Content for Category 1 - Item 1"));
-    m_menuWidget->addLevel2Tab(0, "Item 1-2", new CustomWidget("Content for Category 1 - Item 2"));
-    m_menuWidget->addLevel2Tab(0, "Item 1-3", new CustomWidget("Content for Category 1 - Item 3"));
+    // Set MenuWidget to MainWidget
+    m_mainWidget->setMenuWidget(m_menuWidget);
 
-    // Add level 2 tabs for Category 2 (index 1)
-    m_menuWidget->addLevel2Tab(1, "Item 2-1", new CustomWidget("Content for Category 2 - Item 1"));
-    m_menuWidget->addLevel2Tab(1, "Item 2-2", new CustomWidget("Content for Category 2 - Item 2"));
+    // Build likely next items while the user is idle
+    m_mainWidget->contentPrefetcher()->setEnabled(true);
 
-    // Add level 2 tabs for Category 3 (index 2)
-    m_menuWidget->addLevel2Tab(2, "Item 3-1", new CustomWidget("Content for Category 3 - Item 1"));
-    m_menuWidget->addLevel2Tab(2, "Item 3-2", new CustomWidget("Content for Category 3 - Item 2"));
-    m_menuWidget->addLevel2Tab(2, "Item 3-3", new CustomWidget("Content for Category 3 - Item 3"));
-    m_menuWidget->addLevel2Tab(2, "Item 3-4", new CustomWidget("Content for Category 3 - Item 4"));
+    if (m_nextDemoCategory == DemoCategoryCount) {
+        // Show where the last session left off, or the default widgets
+        if (!restoreSession()) {
+            m_mainWidget->initializeAreas();
+        }
+        setMenuPopulated();
+    } else {
+        // Both areas start in the first category; the session is restored
+        // once the rest of the menu is in place
+        m_mainWidget->initializeAreas();
+    }
 
-    // Set MenuWidget to MainWidget
-    m_mainWidget->setMenuWidget(m_menuWidget);
+    // Ctrl+K jumps to any tab by name
+    SearchPalette *searchPalette = new SearchPalette(m_menuWidget, this);
+    QShortcut *searchShortcut = new QShortcut(QKeySequence(tr("Ctrl+K")), this);
+    connect(searchShortcut, &QShortcut::activated, searchPalette, &SearchPalette::popup);
+}
+
+void MainWindow::addDemoCategory(int categoryIndex)
+{
+    int category = categoryIndex + 1;
+    m_menuWidget->addLevel1Tab(QString("Category %1").arg(category));
+
+    for (int item = 1; item <= DemoItemCounts[categoryIndex]; ++item) {
+        m_menuWidget->addLevel2Tab(categoryIndex, QString("Item %1-%2").arg(category).arg(item),
+                                   lazyContent(QString("Content for Category %1 - Item %2").arg(category).arg(item)));
+    }
+}
+
+void MainWindow::populateNextDemoCategory()
+{
+    if (m_nextDemoCategory >= DemoCategoryCount) {
+        m_populateTimer->stop();
+        return;
+    }
+
+    m_menuWidget->beginUpdate();
+    addDemoCategory(m_nextDemoCategory++);
+    m_menuWidget->endUpdate();
+
+    if (m_nextDemoCategory == DemoCategoryCount) {
+        m_populateTimer->stop();
+        restoreSession();
+        setMenuPopulated();
+    }
+}
+
+void MainWindow::stopDemoPopulation()
+{
+    // The demo menu is being replaced, stop filling it in
+    m_populateTimer->stop();
+    m_nextDemoCategory = DemoCategoryCount;
+    m_menuPopulated = false;
+}
+
+bool MainWindow::isMenuPopulated() const
+{
+    return m_menuPopulated;
+}
+
+void MainWindow::setMenuPopulated()
+{
+    m_menuPopulated = true;
+    emit menuPopulated();
+}
 
-    // Initialize both areas with their default widgets
-    m_mainWidget->initializeAreas();
+bool MainWindow::event(QEvent *event)
+{
+    bool result = QMainWindow::event(event);
+
+    // The first frame is on screen, fill in the rest of the menu
+    if (event->type() == QEvent::Paint && m_nextDemoCategory < DemoCategoryCount
+            && !m_populateTimer->isActive()) {
+        m_populateTimer->start();
+    }
+    return result;
+}
+
+bool MainWindow::restoreSession()
+{
+    QSettings settings(QStringLiteral("MenuWidget"), QStringLiteral("MenuWidget"));
+    if (settings.value(QStringLiteral("session/menu")).toString() != m_menuFile) {
+        return false;
+    }
+    return m_mainWidget->restoreState(settings.value(QStringLiteral("session/state")).toByteArray());
+}
+
+void MainWindow::saveSession() const
+{
+    QSettings settings(QStringLiteral("MenuWidget"), QStringLiteral("MenuWidget"));
+    settings.setValue(QStringLiteral("session/menu"), m_menuFile);
+    settings.setValue(QStringLiteral("session/state"), m_mainWidget->saveState());
 }
@@ -2,23 +2,81 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include "widgets/MenuWidget.h"
 
 class MainWidget;
-class MenuWidget;
+class NavigationRecorder;
+class QTimer;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    explicit MainWindow(QWidget *parent = nullptr);
+    // DeferredStartup builds only the first category of the demo menu
+    // before the window is shown; the others are added one per event
+    // loop turn once the window has painted
+    enum StartupMode { ImmediateStartup, DeferredStartup };
+
+    explicit MainWindow(QWidget *parent = nullptr, StartupMode startupMode = ImmediateStartup);
     ~MainWindow();
 
+    // Rename a category (level 1 tab)
+    void renameCategory(int categoryIndex, const QString &newName);
+
+    // Rename an item (level 2 tab)
+    void renameItem(int categoryIndex, int itemIndex, const QString &newName);
+
+    // Rename many categories and items in one pass
+    void renameTabs(const QVector<MenuWidget::TabTextChange> &changes);
+
+    // Replace the demo menu with a compiled menu file (see tools/menuc),
+    // or with a JSON or XML definition loaded in the background
+    bool loadMenu(const QString &fileName);
+
+    // Every category of the current menu is in place
+    bool isMenuPopulated() const;
+
+    // Log tab selections and area switches to fileName when the window
+    // is destroyed, for replay with tools/navreplay
+    void recordNavigation(const QString &fileName);
+
+signals:
+    // The current menu finished populating (deferred startup, or a menu
+    // loaded in the background)
+    void menuPopulated();
+
+protected:
+    bool event(QEvent *event) override;
+
+private slots:
+    void populateNextDemoCategory();
+
 private:
     MainWidget *m_mainWidget;
     MenuWidget *m_menuWidget;
 
+    // File of the menu shown, empty for the demo menu; a saved session
+    // is only restored over the menu it was saved with
+    QString m_menuFile;
+
+    StartupMode m_startupMode;
+    bool m_menuPopulated;
+
+    // Adds the remaining demo categories in deferred startup
+    QTimer *m_populateTimer;
+    int m_nextDemoCategory;
+
+    NavigationRecorder *m_recorder;
+    QString m_recordFile;
+
     void setupMenuWidget();
+    void addDemoCategory(int categoryIndex);
+    void stopDemoPopulation();
+    void setMenuPopulated();
+    void loadMenuDefinition(const QString &fileName);
+    bool restoreSession();
+    void saveSession() const;
 };
 
 #endif // MAINWINDOW_H
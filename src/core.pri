@@ -0,0 +1,13 @@
+# Include from a project that uses the widget core library (src/core.pro)
+
+QT += core gui widgets concurrent
+
+INCLUDEPATH += $$PWD $$PWD/widgets $$PWD/model $$PWD/trace
+DEPENDPATH += $$PWD $$PWD/widgets $$PWD/model $$PWD/trace
+
+MENUWIDGET_CORE_DIR = $$shadowed($$PWD)
+
+LIBS += -L$$MENUWIDGET_CORE_DIR -lmenuwidgetcore
+
+win32-msvc*: PRE_TARGETDEPS += $$MENUWIDGET_CORE_DIR/menuwidgetcore.lib
+else: PRE_TARGETDEPS += $$MENUWIDGET_CORE_DIR/libmenuwidgetcore.a
@@ -0,0 +1,58 @@
+QT += core gui widgets concurrent
+
+CONFIG += c++11 staticlib
+
+TARGET = menuwidgetcore
+TEMPLATE = lib
+
+# Keep the library next to the Makefile on every platform, core.pri
+# looks for it there
+DESTDIR = $$OUT_PWD
+
+INCLUDEPATH += widgets model
+
+SOURCES += \
+    widgets/MainWidget.cpp \
+    widgets/CustomWidget.cpp \
+    widgets/MenuWidget.cpp \
+    widgets/Container.cpp \
+    widgets/ContainerRegistry.cpp \
+    widgets/BorderFrame.cpp \
+    widgets/TabStrip.cpp \
+    widgets/SearchPalette.cpp \
+    widgets/MirrorWidget.cpp \
+    widgets/ContentPrefetcher.cpp \
+    widgets/NavigationRecorder.cpp \
+    model/MenuModel.cpp \
+    model/PositionIndex.cpp \
+    model/CompiledMenuModel.cpp \
+    model/CompiledMenuWriter.cpp \
+    model/MenuLoader.cpp \
+    model/SearchIndex.cpp \
+    trace/Trace.cpp \
+    trace/StartupTimer.cpp
+
+HEADERS += \
+    widgets/MainWidget.h \
+    widgets/CustomWidget.h \
+    widgets/MenuWidget.h \
+    widgets/Container.h \
+    widgets/ContainerRegistry.h \
+    widgets/BorderFrame.h \
+    widgets/TabStrip.h \
+    widgets/SearchPalette.h \
+    widgets/MirrorWidget.h \
+    widgets/ContentPrefetcher.h \
+    widgets/NavigationRecorder.h \
+    model/MenuModel.h \
+    model/PositionIndex.h \
+    model/CompiledMenuFormat.h \
+    model/CompiledMenuModel.h \
+    model/CompiledMenuWriter.h \
+    model/MenuLoader.h \
+    model/SearchIndex.h \
+    trace/Trace.h \
+    trace/StartupTimer.h
+
+FORMS += \
+    ui/MainWidget.ui
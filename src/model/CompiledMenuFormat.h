@@ -0,0 +1,55 @@
+#ifndef COMPILEDMENUFORMAT_H
+#define COMPILEDMENUFORMAT_H
+
+#include <QtGlobal>
+
+// On-disk layout of a compiled menu file (.menu). All fields are
+// little-endian quint32, every section is 4-byte aligned:
+//
+//   Header
+//   CategoryRecord[categoryCount]
+//   ItemRecord[itemCount]          items of a category are contiguous
+//   QChar[stringsLength]           UTF-16 string table shared by all labels
+//
+// The file is meant to be memory-mapped and read in place.
+namespace CompiledMenu {
+
+// "MENU" read as a little-endian quint32
+const quint32 Magic = 0x554e454d;
+const quint32 Version = 1;
+
+// A string in the string table, in UTF-16 code units
+struct StringRef {
+    quint32 offset;
+    quint32 length;
+};
+
+struct Header {
+    quint32 magic;
+    quint32 version;
+    quint32 categoryCount;
+    quint32 itemCount;
+    quint32 categoriesOffset;   // Byte offset of the category records
+    quint32 itemsOffset;        // Byte offset of the item records
+    quint32 stringsOffset;      // Byte offset of the string table
+    quint32 stringsLength;      // Size of the string table in UTF-16 code units
+};
+
+struct CategoryRecord {
+    StringRef label;
+    quint32 firstItem;          // Index of the category's first item record
+    quint32 itemCount;
+};
+
+struct ItemRecord {
+    StringRef label;
+    StringRef content;          // Text of the item's content widget
+};
+
+Q_STATIC_ASSERT(sizeof(Header) == 32);
+Q_STATIC_ASSERT(sizeof(CategoryRecord) == 16);
+Q_STATIC_ASSERT(sizeof(ItemRecord) == 16);
+
+}
+
+#endif // COMPILEDMENUFORMAT_H
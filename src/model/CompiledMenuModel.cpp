@@ -0,0 +1,242 @@
+#include "CompiledMenuModel.h"
+#include "MenuModel.h"
+
+#include <QSysInfo>
+#include <climits>
+
+using namespace CompiledMenu;
+
+// Internal id of a model index: 0 for categories, (category row + 1) for items
+static const quintptr CategoryId = 0;
+
+CompiledMenuModel::CompiledMenuModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_data(nullptr)
+    , m_header(nullptr)
+    , m_categories(nullptr)
+    , m_items(nullptr)
+    , m_strings(nullptr)
+{
+}
+
+CompiledMenuModel::~CompiledMenuModel()
+{
+    unmap();
+}
+
+bool CompiledMenuModel::open(const QString &fileName)
+{
+    beginResetModel();
+    unmap();
+    m_errorString.clear();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        endResetModel();
+        return false;
+    }
+
+    qint64 size = m_file.size();
+    m_data = m_file.map(0, size);
+
+    // Strings are used in place, so they must already be in host order
+    if (!m_data) {
+        m_errorString = m_file.errorString();
+    } else if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) {
+        m_errorString = tr("Compiled menus can only be mapped on little-endian hosts");
+    } else if (validate(size)) {
+        endResetModel();
+        return true;
+    }
+
+    unmap();
+    endResetModel();
+    return false;
+}
+
+void CompiledMenuModel::close()
+{
+    beginResetModel();
+    unmap();
+    endResetModel();
+}
+
+bool CompiledMenuModel::isOpen() const
+{
+    return m_header != nullptr;
+}
+
+QString CompiledMenuModel::errorString() const
+{
+    return m_errorString;
+}
+
+bool CompiledMenuModel::validate(qint64 size)
+{
+    // Every offset is checked once here so lookups can index the mapping directly
+    if (size < qint64(sizeof(Header))) {
+        m_errorString = tr("File is too small to be a compiled menu");
+        return false;
+    }
+
+    const Header *header = reinterpret_cast<const Header*>(m_data);
+    if (header->magic != Magic || header->version != Version) {
+        m_errorString = tr("Not a compiled menu file, or an unsupported version");
+        return false;
+    }
+
+    qint64 categoriesEnd = qint64(header->categoriesOffset) + qint64(header->categoryCount) * sizeof(CategoryRecord);
+    qint64 itemsEnd = qint64(header->itemsOffset) + qint64(header->itemCount) * sizeof(ItemRecord);
+    qint64 stringsEnd = qint64(header->stringsOffset) + qint64(header->stringsLength) * sizeof(QChar);
+
+    if (header->categoriesOffset % 4 != 0 || header->itemsOffset % 4 != 0
+            || header->stringsOffset % 2 != 0
+            || categoriesEnd > size || itemsEnd > size || stringsEnd > size
+            || header->categoryCount > quint32(INT_MAX) || header->itemCount > quint32(INT_MAX)) {
+        m_errorString = tr("Compiled menu sections are out of bounds");
+        return false;
+    }
+
+    const CategoryRecord *categories = reinterpret_cast<const CategoryRecord*>(m_data + header->categoriesOffset);
+    const ItemRecord *items = reinterpret_cast<const ItemRecord*>(m_data + header->itemsOffset);
+
+    auto stringInBounds = [header](const StringRef &ref) {
+        return qint64(ref.offset) + ref.length <= header->stringsLength;
+    };
+
+    for (quint32 i = 0; i < header->categoryCount; ++i) {
+        const CategoryRecord &category = categories[i];
+        if (!stringInBounds(category.label)
+                || qint64(category.firstItem) + category.itemCount > header->itemCount) {
+            m_errorString = tr("Compiled menu category %1 is corrupt").arg(i);
+            return false;
+        }
+    }
+
+    for (quint32 i = 0; i < header->itemCount; ++i) {
+        if (!stringInBounds(items[i].label) || !stringInBounds(items[i].content)) {
+            m_errorString = tr("Compiled menu item %1 is corrupt").arg(i);
+            return false;
+        }
+    }
+
+    m_header = header;
+    m_categories = categories;
+    m_items = items;
+    m_strings = reinterpret_cast<const QChar*>(m_data + header->stringsOffset);
+    return true;
+}
+
+void CompiledMenuModel::unmap()
+{
+    m_header = nullptr;
+    m_categories = nullptr;
+    m_items = nullptr;
+    m_strings = nullptr;
+
+    if (m_data) {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+
+    m_file.close();
+}
+
+QString CompiledMenuModel::rawString(const StringRef &ref) const
+{
+    // No copy: the string points into the mapping
+    return QString::fromRawData(m_strings + ref.offset, int(ref.length));
+}
+
+const ItemRecord &CompiledMenuModel::item(const QModelIndex &index) const
+{
+    const CategoryRecord &category = m_categories[index.internalId() - 1];
+    return m_items[category.firstItem + quint32(index.row())];
+}
+
+QModelIndex CompiledMenuModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column != 0 || row < 0 || row >= rowCount(parent)) {
+        return QModelIndex();
+    }
+
+    if (!parent.isValid()) {
+        return createIndex(row, 0, CategoryId);
+    }
+
+    return createIndex(row, 0, quintptr(parent.row()) + 1);
+}
+
+QModelIndex CompiledMenuModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == CategoryId) {
+        return QModelIndex();
+    }
+
+    return createIndex(int(child.internalId() - 1), 0, CategoryId);
+}
+
+int CompiledMenuModel::rowCount(const QModelIndex &parent) const
+{
+    if (!m_header) {
+        return 0;
+    }
+
+    if (!parent.isValid()) {
+        return int(m_header->categoryCount);
+    }
+
+    // Only categories have children
+    if (parent.internalId() != CategoryId) {
+        return 0;
+    }
+
+    return int(m_categories[parent.row()].itemCount);
+}
+
+int CompiledMenuModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant CompiledMenuModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || !m_header) {
+        return QVariant();
+    }
+
+    if (index.internalId() == CategoryId) {
+        // Few and long-lived (the level 1 QTabBar keeps them), so copied
+        if (role == Qt::DisplayRole) {
+            const StringRef &label = m_categories[index.row()].label;
+            return QString(m_strings + label.offset, int(label.length));
+        }
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return rawString(item(index).label);
+    case MenuModel::ContentTextRole: {
+        // Ends up in a QLabel that may outlive the mapping, so copied
+        const StringRef &content = item(index).content;
+        if (content.length == 0) {
+            return QVariant();
+        }
+        return QString(m_strings + content.offset, int(content.length));
+    }
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags CompiledMenuModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
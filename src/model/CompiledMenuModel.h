@@ -0,0 +1,56 @@
+#ifndef COMPILEDMENUMODEL_H
+#define COMPILEDMENUMODEL_H
+
+#include <QAbstractItemModel>
+#include <QFile>
+#include "CompiledMenuFormat.h"
+
+// Read-only menu catalog backed by a memory-mapped compiled menu file.
+// Nothing is parsed or copied on open(); item labels are returned as
+// QStrings pointing into the mapping, so they are only valid until
+// close(). Copy them if they must outlive the catalog.
+//
+// Same shape as MenuModel: categories are top-level rows, items their
+// children, and MenuModel::ContentTextRole gives the content text.
+class CompiledMenuModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit CompiledMenuModel(QObject *parent = nullptr);
+    ~CompiledMenuModel();
+
+    // Map a compiled menu file, replacing the current catalog.
+    // Returns false (and keeps an empty catalog) if the file is invalid.
+    bool open(const QString &fileName);
+    void close();
+
+    bool isOpen() const;
+    QString errorString() const;
+
+    // QAbstractItemModel interface
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+private:
+    bool validate(qint64 size);
+    void unmap();
+    QString rawString(const CompiledMenu::StringRef &ref) const;
+    const CompiledMenu::ItemRecord &item(const QModelIndex &index) const;
+
+    QFile m_file;
+    uchar *m_data;
+    QString m_errorString;
+
+    // Views into the mapping, null when nothing is open
+    const CompiledMenu::Header *m_header;
+    const CompiledMenu::CategoryRecord *m_categories;
+    const CompiledMenu::ItemRecord *m_items;
+    const QChar *m_strings;
+};
+
+#endif // COMPILEDMENUMODEL_H
@@ -0,0 +1,187 @@
+#include "CompiledMenuWriter.h"
+
+#include <QIODevice>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtEndian>
+
+using namespace CompiledMenu;
+
+namespace {
+
+// Collects strings into one UTF-16 table, storing duplicates once
+class StringTable
+{
+public:
+    StringRef add(const QString &text)
+    {
+        StringRef ref = { 0, 0 };
+        if (text.isEmpty()) {
+            return ref;
+        }
+
+        QHash<QString, quint32>::const_iterator it = m_offsets.constFind(text);
+        if (it != m_offsets.constEnd()) {
+            ref.offset = it.value();
+        } else {
+            ref.offset = quint32(m_chars.size());
+            m_offsets.insert(text, ref.offset);
+            m_chars.append(text);
+        }
+
+        ref.length = quint32(text.size());
+        return ref;
+    }
+
+    const QString &chars() const { return m_chars; }
+
+private:
+    QString m_chars;
+    QHash<QString, quint32> m_offsets;
+};
+
+void appendWords(QByteArray &out, const quint32 *words, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        quint32 word = qToLittleEndian(words[i]);
+        out.append(reinterpret_cast<const char*>(&word), sizeof(word));
+    }
+}
+
+template <typename Record>
+void appendRecord(QByteArray &out, const Record &record)
+{
+    // Records are plain arrays of quint32
+    appendWords(out, reinterpret_cast<const quint32*>(&record), int(sizeof(Record) / sizeof(quint32)));
+}
+
+}
+
+CompiledMenuWriter::CompiledMenuWriter()
+    : m_itemCount(0)
+{
+}
+
+int CompiledMenuWriter::addCategory(const QString &label)
+{
+    Category category;
+    category.label = label;
+    m_categories.append(category);
+    return m_categories.size() - 1;
+}
+
+void CompiledMenuWriter::addItem(int category, const QString &label, const QString &content)
+{
+    if (category < 0 || category >= m_categories.size()) {
+        return;
+    }
+
+    Item item;
+    item.label = label;
+    item.content = content;
+    m_categories[category].items.append(item);
+    ++m_itemCount;
+}
+
+bool CompiledMenuWriter::addJson(const QByteArray &json)
+{
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    if (document.isNull()) {
+        m_errorString = error.errorString();
+        return false;
+    }
+
+    const QJsonArray categories = document.object().value(QStringLiteral("categories")).toArray();
+    for (const QJsonValue &categoryValue : categories) {
+        QJsonObject categoryObject = categoryValue.toObject();
+        int category = addCategory(categoryObject.value(QStringLiteral("label")).toString());
+
+        const QJsonArray items = categoryObject.value(QStringLiteral("items")).toArray();
+        for (const QJsonValue &itemValue : items) {
+            QJsonObject itemObject = itemValue.toObject();
+            addItem(category,
+                    itemObject.value(QStringLiteral("label")).toString(),
+                    itemObject.value(QStringLiteral("content")).toString());
+        }
+    }
+
+    return true;
+}
+
+bool CompiledMenuWriter::write(QIODevice *device)
+{
+    if (!device || !device->isWritable()) {
+        m_errorString = QStringLiteral("Device is not writable");
+        return false;
+    }
+
+    StringTable strings;
+    QByteArray categoryRecords;
+    QByteArray itemRecords;
+    categoryRecords.reserve(m_categories.size() * int(sizeof(CategoryRecord)));
+    itemRecords.reserve(m_itemCount * int(sizeof(ItemRecord)));
+
+    quint32 firstItem = 0;
+    for (const Category &category : m_categories) {
+        CategoryRecord categoryRecord;
+        categoryRecord.label = strings.add(category.label);
+        categoryRecord.firstItem = firstItem;
+        categoryRecord.itemCount = quint32(category.items.size());
+        appendRecord(categoryRecords, categoryRecord);
+
+        for (const Item &item : category.items) {
+            ItemRecord itemRecord;
+            itemRecord.label = strings.add(item.label);
+            itemRecord.content = strings.add(item.content);
+            appendRecord(itemRecords, itemRecord);
+        }
+
+        firstItem += categoryRecord.itemCount;
+    }
+
+    Header header;
+    header.magic = Magic;
+    header.version = Version;
+    header.categoryCount = quint32(m_categories.size());
+    header.itemCount = quint32(m_itemCount);
+    header.categoriesOffset = sizeof(Header);
+    header.itemsOffset = header.categoriesOffset + quint32(categoryRecords.size());
+    header.stringsOffset = header.itemsOffset + quint32(itemRecords.size());
+    header.stringsLength = quint32(strings.chars().size());
+
+    QByteArray headerBytes;
+    appendRecord(headerBytes, header);
+
+    // The string table is stored as little-endian UTF-16
+    QByteArray stringBytes;
+    stringBytes.resize(strings.chars().size() * int(sizeof(ushort)));
+    qToLittleEndian<ushort>(strings.chars().utf16(), strings.chars().size(), stringBytes.data());
+
+    if (device->write(headerBytes) != headerBytes.size()
+            || device->write(categoryRecords) != categoryRecords.size()
+            || device->write(itemRecords) != itemRecords.size()
+            || device->write(stringBytes) != stringBytes.size()) {
+        m_errorString = device->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+int CompiledMenuWriter::categoryCount() const
+{
+    return m_categories.size();
+}
+
+int CompiledMenuWriter::itemCount() const
+{
+    return m_itemCount;
+}
+
+QString CompiledMenuWriter::errorString() const
+{
+    return m_errorString;
+}
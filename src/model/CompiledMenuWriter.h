@@ -0,0 +1,52 @@
+#ifndef COMPILEDMENUWRITER_H
+#define COMPILEDMENUWRITER_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include "CompiledMenuFormat.h"
+
+class QIODevice;
+
+// Builds a compiled menu file (see CompiledMenuFormat.h) for
+// CompiledMenuModel. Identical strings are stored once.
+class CompiledMenuWriter
+{
+public:
+    CompiledMenuWriter();
+
+    // Append a category and return its index
+    int addCategory(const QString &label);
+
+    // Append an item to a category (ignored if the category is invalid)
+    void addItem(int category, const QString &label, const QString &content = QString());
+
+    // Add the categories of a JSON menu definition:
+    //   { "categories": [ { "label": "...",
+    //                       "items": [ { "label": "...", "content": "..." } ] } ] }
+    bool addJson(const QByteArray &json);
+
+    // Write the compiled menu
+    bool write(QIODevice *device);
+
+    int categoryCount() const;
+    int itemCount() const;
+    QString errorString() const;
+
+private:
+    struct Item {
+        QString label;
+        QString content;
+    };
+
+    struct Category {
+        QString label;
+        QVector<Item> items;
+    };
+
+    QVector<Category> m_categories;
+    int m_itemCount;
+    QString m_errorString;
+};
+
+#endif // COMPILEDMENUWRITER_H
@@ -0,0 +1,321 @@
+#include "MenuLoader.h"
+#include "MenuModel.h"
+
+#include <QTimer>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QXmlStreamReader>
+#include <QtConcurrent>
+
+namespace {
+
+// Items appended per model insertion
+const int ChunkSize = 2000;
+
+// Time spent appending per event loop pass, so input and painting go on
+const int DeliveryBudgetMs = 8;
+
+void parseJson(const QByteArray &data, MenuLoader::ParsedMenu &menu)
+{
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(data, &error);
+    if (document.isNull()) {
+        menu.errorString = error.errorString();
+        return;
+    }
+
+    // Only the labels are read here; items are converted in parallel later
+    const QJsonArray categories = document.object().value(QStringLiteral("categories")).toArray();
+    menu.categoryLabels.reserve(categories.size());
+    menu.jsonCategories.reserve(categories.size());
+
+    for (const QJsonValue &value : categories) {
+        QJsonObject category = value.toObject();
+        menu.categoryLabels.append(category.value(QStringLiteral("label")).toString());
+        menu.jsonCategories.append(category);
+    }
+}
+
+void parseXml(const QByteArray &data, MenuLoader::ParsedMenu &menu)
+{
+    QXmlStreamReader xml(data);
+
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        if (xml.name() == QLatin1String("category")) {
+            MenuLoader::Category category;
+            category.row = menu.categories.size();
+            category.label = xml.attributes().value(QStringLiteral("label")).toString();
+            menu.categoryLabels.append(category.label);
+            menu.categories.append(category);
+        } else if (xml.name() == QLatin1String("item") && !menu.categories.isEmpty()) {
+            MenuLoader::Category &category = menu.categories.last();
+            category.itemLabels.append(xml.attributes().value(QStringLiteral("label")).toString());
+            category.itemContents.append(xml.readElementText());
+        }
+    }
+
+    if (xml.hasError()) {
+        menu.errorString = xml.errorString();
+    }
+}
+
+// Runs on a worker thread
+MenuLoader::ParsedMenu parseMenuFile(const QString &fileName)
+{
+    MenuLoader::ParsedMenu menu;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        menu.errorString = file.errorString();
+        return menu;
+    }
+
+    QByteArray data = file.readAll();
+    if (fileName.endsWith(QLatin1String(".xml"), Qt::CaseInsensitive)) {
+        parseXml(data, menu);
+    } else {
+        parseJson(data, menu);
+    }
+
+    return menu;
+}
+
+// Converts one JSON category on the thread pool
+struct ConvertJsonCategory
+{
+    typedef MenuLoader::Category result_type;
+
+    explicit ConvertJsonCategory(const QVector<QJsonObject> &categories)
+        : categories(categories) {}
+
+    MenuLoader::Category operator()(int row) const
+    {
+        const QJsonObject &object = categories.at(row);
+
+        MenuLoader::Category category;
+        category.row = row;
+        category.label = object.value(QStringLiteral("label")).toString();
+
+        const QJsonArray items = object.value(QStringLiteral("items")).toArray();
+        category.itemLabels.reserve(items.size());
+        category.itemContents.reserve(items.size());
+
+        for (const QJsonValue &value : items) {
+            QJsonObject item = value.toObject();
+            category.itemLabels.append(item.value(QStringLiteral("label")).toString());
+            category.itemContents.append(item.value(QStringLiteral("content")).toString());
+        }
+
+        return category;
+    }
+
+    QVector<QJsonObject> categories;
+};
+
+}
+
+MenuLoader::MenuLoader(MenuModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_priorityCategory(0)
+    , m_priorityRow(0)
+    , m_awaitingPriority(false)
+    , m_deliveredItems(0)
+    , m_totalCategories(0)
+    , m_loadedCategories(0)
+    , m_loading(false)
+{
+    m_deliveryTimer = new QTimer(this);
+    m_deliveryTimer->setSingleShot(true);
+    m_deliveryTimer->setInterval(0);
+    connect(m_deliveryTimer, &QTimer::timeout, this, &MenuLoader::deliverChunk);
+
+    connect(&m_parseWatcher, &QFutureWatcher<ParsedMenu>::finished,
+            this, &MenuLoader::onParsed);
+    connect(&m_convertWatcher, &QFutureWatcher<Category>::resultReadyAt,
+            this, &MenuLoader::onCategoryConverted);
+}
+
+MenuLoader::~MenuLoader()
+{
+    // Conversions work on their own copy of the document, they just stop early
+    m_convertWatcher.cancel();
+}
+
+void MenuLoader::setPriorityCategory(int category)
+{
+    m_priorityCategory = category;
+}
+
+void MenuLoader::load(const QString &fileName)
+{
+    cancel();
+
+    m_deliveredItems = 0;
+    m_priorityRow = 0;
+    m_awaitingPriority = false;
+    m_categoryIds.clear();
+    m_totalCategories = 0;
+    m_loadedCategories = 0;
+    m_loading = true;
+
+    m_parseWatcher.setFuture(QtConcurrent::run(&parseMenuFile, fileName));
+}
+
+void MenuLoader::cancel()
+{
+    if (!m_loading) {
+        return;
+    }
+
+    stop();
+    emit canceled();
+}
+
+bool MenuLoader::isLoading() const
+{
+    return m_loading;
+}
+
+void MenuLoader::stop()
+{
+    // A running parse cannot be interrupted, its result is ignored instead
+    m_loading = false;
+    m_convertWatcher.cancel();
+    m_deliveryTimer->stop();
+    m_queue.clear();
+    m_deliveredItems = 0;
+}
+
+void MenuLoader::onParsed()
+{
+    if (!m_loading || m_parseWatcher.future().resultCount() == 0) {
+        return;
+    }
+
+    ParsedMenu menu = m_parseWatcher.result();
+
+    if (!m_model || !menu.errorString.isEmpty()) {
+        stop();
+        emit failed(m_model ? menu.errorString : QStringLiteral("Menu model was deleted"));
+        return;
+    }
+
+    m_totalCategories = menu.categoryLabels.size();
+    if (m_totalCategories == 0) {
+        m_loading = false;
+        emit finished();
+        return;
+    }
+
+    // Every category tab appears at once, items follow
+    int firstRow = m_model->appendCategories(menu.categoryLabels);
+    m_categoryIds.resize(m_totalCategories);
+    for (int row = 0; row < m_totalCategories; ++row) {
+        m_categoryIds[row] = m_model->categoryId(firstRow + row);
+    }
+
+    // The category on screen goes first
+    m_priorityRow = qBound(0, m_priorityCategory, m_totalCategories - 1);
+    m_awaitingPriority = true;
+    QVector<int> order;
+    order.reserve(m_totalCategories);
+    order.append(m_priorityRow);
+    for (int row = 0; row < m_totalCategories; ++row) {
+        if (row != m_priorityRow) {
+            order.append(row);
+        }
+    }
+
+    if (!menu.jsonCategories.isEmpty()) {
+        m_convertWatcher.setFuture(QtConcurrent::mapped(order, ConvertJsonCategory(menu.jsonCategories)));
+    } else {
+        for (int row : order) {
+            enqueue(menu.categories.at(row));
+        }
+    }
+}
+
+void MenuLoader::onCategoryConverted(int index)
+{
+    if (m_loading) {
+        enqueue(m_convertWatcher.resultAt(index));
+    }
+}
+
+void MenuLoader::enqueue(const Category &category)
+{
+    // Results of the thread pool arrive in any order; the others queue up
+    // until the priority category is in, so nothing delays it
+    if (category.row == m_priorityRow) {
+        m_queue.prepend(category);
+        m_awaitingPriority = false;
+    } else {
+        m_queue.append(category);
+    }
+
+    if (!m_awaitingPriority && !m_deliveryTimer->isActive()) {
+        m_deliveryTimer->start();
+    }
+}
+
+void MenuLoader::deliverChunk()
+{
+    if (!m_loading) {
+        return;
+    }
+
+    if (!m_model) {
+        stop();
+        emit failed(QStringLiteral("Menu model was deleted"));
+        return;
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+
+    while (!m_queue.isEmpty() && budget.elapsed() < DeliveryBudgetMs) {
+        const Category &category = m_queue.first();
+
+        // A category removed meanwhile gets no items
+        QModelIndex categoryIndex = m_model->indexForId(m_categoryIds.value(category.row));
+        if (!categoryIndex.isValid()) {
+            m_queue.removeFirst();
+            m_deliveredItems = 0;
+            ++m_loadedCategories;
+            emit progress(m_loadedCategories, m_totalCategories);
+            continue;
+        }
+        int row = categoryIndex.row();
+
+        int count = qMin(ChunkSize, category.itemLabels.size() - m_deliveredItems);
+        if (count > 0) {
+            m_model->appendTextItems(row,
+                                     category.itemLabels.mid(m_deliveredItems, count),
+                                     category.itemContents.mid(m_deliveredItems, count));
+            m_deliveredItems += count;
+        }
+
+        if (m_deliveredItems >= category.itemLabels.size()) {
+            m_queue.removeFirst();
+            m_deliveredItems = 0;
+            ++m_loadedCategories;
+
+            emit categoryLoaded(row);
+            emit progress(m_loadedCategories, m_totalCategories);
+        }
+    }
+
+    if (!m_queue.isEmpty()) {
+        m_deliveryTimer->start();
+    } else if (m_loadedCategories == m_totalCategories) {
+        m_loading = false;
+        emit finished();
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef MENULOADER_H
+#define MENULOADER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QJsonObject>
+#include <QVector>
+#include <QList>
+#include "MenuModel.h"
+
+class QTimer;
+
+// Loads a JSON or XML menu definition into a MenuModel without blocking
+// the GUI thread. Parsing runs on a worker thread, JSON categories are
+// converted in parallel on the global thread pool, and the results are
+// appended to the model in small chunks from the event loop, so the
+// window stays responsive and fills in progressively.
+//
+// All category tabs are added as soon as the file is parsed; the
+// priority category (the one on screen) gets its items first.
+//
+// JSON: { "categories": [ { "label": "...",
+//                           "items": [ { "label": "...", "content": "..." } ] } ] }
+// XML:  <menu><category label="..."><item label="...">content</item></category></menu>
+class MenuLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MenuLoader(MenuModel *model, QObject *parent = nullptr);
+    ~MenuLoader();
+
+    // Category (relative to the loaded file) whose items are delivered first
+    void setPriorityCategory(int category);
+
+    // Start loading, cancelling any load in progress
+    void load(const QString &fileName);
+
+    // Stop delivering; items already appended stay in the model
+    void cancel();
+
+    bool isLoading() const;
+
+    // Parsed definition of one category, in plain data
+    struct Category {
+        int row;
+        QString label;
+        QStringList itemLabels;
+        QStringList itemContents;
+    };
+
+    // Result of the parse step; JSON categories still need converting
+    struct ParsedMenu {
+        QString errorString;
+        QStringList categoryLabels;
+        QVector<Category> categories;
+        QVector<QJsonObject> jsonCategories;
+    };
+
+signals:
+    // Number of categories whose items are all in the model
+    void progress(int loadedCategories, int totalCategories);
+
+    // All items of a category are in the model (row in the model)
+    void categoryLoaded(int category);
+
+    void finished();
+    void failed(const QString &errorString);
+    void canceled();
+
+private slots:
+    void onParsed();
+    void onCategoryConverted(int index);
+    void deliverChunk();
+
+private:
+    void enqueue(const Category &category);
+    void stop();
+
+    QPointer<MenuModel> m_model;
+    int m_priorityCategory;
+
+    // Row in the file of the priority category of the current load, and
+    // whether delivery waits for it to be converted
+    int m_priorityRow;
+    bool m_awaitingPriority;
+
+    QFutureWatcher<ParsedMenu> m_parseWatcher;
+    QFutureWatcher<Category> m_convertWatcher;
+
+    // Converted categories waiting to be appended, priority one first,
+    // and how many items of the front one are already in the model
+    QList<Category> m_queue;
+    int m_deliveredItems;
+
+    // Ids of the appended categories by row in the file, so items reach
+    // their category however the model's rows are removed or moved
+    QVector<MenuModel::Id> m_categoryIds;
+
+    int m_totalCategories;
+    int m_loadedCategories;
+    bool m_loading;
+
+    // Runs deliverChunk() from the event loop
+    QTimer *m_deliveryTimer;
+};
+
+#endif // MENULOADER_H
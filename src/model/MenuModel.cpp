@@ -0,0 +1,497 @@
+#include "MenuModel.h"
+
+#include <QMap>
+#include <algorithm>
+
+MenuModel::MenuModel(QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_nextId(1)
+{
+}
+
+MenuModel::~MenuModel()
+{
+}
+
+int MenuModel::appendCategory(const QString &label)
+{
+    int row = m_categoryOrder.size();
+
+    beginInsertRows(QModelIndex(), row, row);
+    appendCategoryRow(label);
+    endInsertRows();
+
+    return row;
+}
+
+int MenuModel::appendCategories(const QStringList &labels)
+{
+    if (labels.isEmpty()) {
+        return -1;
+    }
+
+    int first = m_categoryOrder.size();
+
+    beginInsertRows(QModelIndex(), first, first + labels.size() - 1);
+    m_categories.reserve(first + labels.size());
+    for (const QString &label : labels) {
+        appendCategoryRow(label);
+    }
+    endInsertRows();
+
+    return first;
+}
+
+int MenuModel::appendItem(int category, const QString &label, const ContentFactory &factory)
+{
+    if (!isValidCategory(category)) {
+        return -1;
+    }
+
+    int row = categoryAt(category)->items.size();
+
+    beginInsertRows(index(category, 0), row, row);
+    Item *item = appendItemRow(category);
+    item->label = label;
+    item->factory = factory;
+    endInsertRows();
+
+    return row;
+}
+
+int MenuModel::appendItems(int category, const QStringList &labels, const QList<ContentFactory> &factories)
+{
+    if (!isValidCategory(category) || labels.isEmpty()) {
+        return -1;
+    }
+
+    int first = categoryAt(category)->items.size();
+
+    beginInsertRows(index(category, 0), first, first + labels.size() - 1);
+    m_items.reserve(m_items.size() + labels.size());
+    for (int i = 0; i < labels.size(); ++i) {
+        Item *item = appendItemRow(category);
+        item->label = labels.at(i);
+        item->factory = factories.value(i);
+    }
+    endInsertRows();
+
+    return first;
+}
+
+int MenuModel::appendTextItems(int category, const QStringList &labels, const QStringList &contents,
+                               const QString &contentType)
+{
+    if (!isValidCategory(category) || labels.isEmpty()) {
+        return -1;
+    }
+
+    int first = categoryAt(category)->items.size();
+
+    beginInsertRows(index(category, 0), first, first + labels.size() - 1);
+    m_items.reserve(m_items.size() + labels.size());
+    for (int i = 0; i < labels.size(); ++i) {
+        Item *item = appendItemRow(category);
+        item->label = labels.at(i);
+        item->contentText = contents.value(i);
+        item->contentType = contentType;
+    }
+    endInsertRows();
+
+    return first;
+}
+
+int MenuModel::categoryCount() const
+{
+    return m_categoryOrder.size();
+}
+
+int MenuModel::itemCount(int category) const
+{
+    const Category *entry = categoryAt(category);
+    return entry ? entry->items.size() : 0;
+}
+
+QString MenuModel::categoryLabel(int category) const
+{
+    const Category *entry = categoryAt(category);
+    return entry ? entry->label : QString();
+}
+
+QString MenuModel::itemLabel(int category, int item) const
+{
+    const Item *entry = itemAt(category, item);
+    return entry ? entry->label : QString();
+}
+
+MenuModel::ContentFactory MenuModel::itemFactory(int category, int item) const
+{
+    const Item *entry = itemAt(category, item);
+    return entry ? entry->factory : ContentFactory();
+}
+
+MenuModel::Id MenuModel::categoryId(int category) const
+{
+    return m_categoryOrder.at(category);
+}
+
+MenuModel::Id MenuModel::itemId(int category, int item) const
+{
+    const Category *entry = categoryAt(category);
+    return entry ? entry->items.at(item) : 0;
+}
+
+QModelIndex MenuModel::indexForId(Id id) const
+{
+    auto item = m_items.constFind(id);
+    if (item != m_items.constEnd()) {
+        auto category = m_categories.constFind(item->category);
+        return createIndex(category->items.positionOf(id), 0, id);
+    }
+
+    int row = m_categoryOrder.positionOf(id);
+    return row >= 0 ? createIndex(row, 0, id) : QModelIndex();
+}
+
+bool MenuModel::removeCategory(int category)
+{
+    return removeRows(category, 1);
+}
+
+bool MenuModel::removeItem(int category, int item)
+{
+    return isValidCategory(category) && removeRows(item, 1, index(category, 0));
+}
+
+bool MenuModel::moveCategory(int from, int to)
+{
+    if (!isValidCategory(from) || !isValidCategory(to)) {
+        return false;
+    }
+
+    // Rows are moved before destinationChild, counted before the move
+    return from == to || moveRows(QModelIndex(), from, 1, QModelIndex(), to > from ? to + 1 : to);
+}
+
+bool MenuModel::moveItem(int category, int from, int to)
+{
+    if (!isValidItem(category, from) || !isValidItem(category, to)) {
+        return false;
+    }
+
+    QModelIndex parent = index(category, 0);
+    return from == to || moveRows(parent, from, 1, parent, to > from ? to + 1 : to);
+}
+
+bool MenuModel::setCategoryLabel(int category, const QString &label)
+{
+    return setData(index(category, 0), label, Qt::EditRole);
+}
+
+bool MenuModel::setItemLabel(int category, int item, const QString &label)
+{
+    return setData(index(item, 0, index(category, 0)), label, Qt::EditRole);
+}
+
+int MenuModel::setLabels(const QVector<LabelChange> &changes)
+{
+    // Changed rows per parent: -1 for categories, else the category row
+    QMap<int, QVector<int> > changedRows;
+
+    for (const LabelChange &change : changes) {
+        if (change.item < 0) {
+            Category *category = categoryAt(change.category);
+            if (!category) {
+                continue;
+            }
+            category->label = change.label;
+            changedRows[-1].append(change.category);
+        } else {
+            Item *item = itemAt(change.category, change.item);
+            if (!item) {
+                continue;
+            }
+            item->label = change.label;
+            changedRows[change.category].append(change.item);
+        }
+    }
+
+    int applied = 0;
+
+    // Notify per run of adjacent rows so views only revisit what changed
+    for (auto it = changedRows.begin(); it != changedRows.end(); ++it) {
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        applied += rows.size();
+
+        QModelIndex parent = it.key() < 0 ? QModelIndex() : index(it.key(), 0);
+        int first = rows.first();
+        for (int i = 1; i <= rows.size(); ++i) {
+            if (i == rows.size() || rows.at(i) != rows.at(i - 1) + 1) {
+                emitLabelsChanged(parent, first, rows.at(i - 1));
+                if (i < rows.size()) {
+                    first = rows.at(i);
+                }
+            }
+        }
+    }
+
+    return applied;
+}
+
+QModelIndex MenuModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column != 0 || row < 0) {
+        return QModelIndex();
+    }
+
+    if (!parent.isValid()) {
+        Id id = m_categoryOrder.at(row);
+        return id ? createIndex(row, 0, id) : QModelIndex();
+    }
+
+    // Only categories have children
+    auto category = m_categories.constFind(parent.internalId());
+    if (category == m_categories.constEnd()) {
+        return QModelIndex();
+    }
+
+    Id id = category->items.at(row);
+    return id ? createIndex(row, 0, id) : QModelIndex();
+}
+
+QModelIndex MenuModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    auto item = m_items.constFind(child.internalId());
+    if (item == m_items.constEnd()) {
+        return QModelIndex();
+    }
+
+    return createIndex(m_categoryOrder.positionOf(item->category), 0, item->category);
+}
+
+int MenuModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return m_categoryOrder.size();
+    }
+
+    auto category = m_categories.constFind(parent.internalId());
+    return category == m_categories.constEnd() ? 0 : category->items.size();
+}
+
+int MenuModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant MenuModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (role == IdRole) {
+        return QVariant::fromValue(Id(index.internalId()));
+    }
+
+    auto item = m_items.constFind(index.internalId());
+    if (item == m_items.constEnd()) {
+        auto category = m_categories.constFind(index.internalId());
+        if (category != m_categories.constEnd() && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+            return category->label;
+        }
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return item->label;
+    case ContentFactoryRole:
+        return item->factory ? QVariant::fromValue(item->factory) : QVariant();
+    case ContentTextRole:
+        return item->contentText.isEmpty() ? QVariant() : QVariant(item->contentText);
+    case ContentTypeRole:
+        return item->contentType.isEmpty() ? QVariant() : QVariant(item->contentType);
+    default:
+        return QVariant();
+    }
+}
+
+bool MenuModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || (role != Qt::EditRole && role != Qt::DisplayRole)) {
+        return false;
+    }
+
+    QString label = value.toString();
+
+    auto item = m_items.find(index.internalId());
+    if (item != m_items.end()) {
+        item->label = label;
+    } else {
+        auto category = m_categories.find(index.internalId());
+        if (category == m_categories.end()) {
+            return false;
+        }
+        category->label = label;
+    }
+
+    emitLabelsChanged(index.parent(), index.row(), index.row());
+    return true;
+}
+
+Qt::ItemFlags MenuModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+bool MenuModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (row < 0 || count <= 0 || row + count > rowCount(parent)) {
+        return false;
+    }
+
+    beginRemoveRows(parent, row, row + count - 1);
+    if (!parent.isValid()) {
+        // A category takes its items along
+        for (Id id : m_categoryOrder.remove(row, count)) {
+            for (Id itemId : m_categories.constFind(id)->items.ids()) {
+                m_items.remove(itemId);
+            }
+            m_categories.remove(id);
+        }
+    } else {
+        for (Id id : m_categories[parent.internalId()].items.remove(row, count)) {
+            m_items.remove(id);
+        }
+    }
+    endRemoveRows();
+
+    return true;
+}
+
+bool MenuModel::moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                         const QModelIndex &destinationParent, int destinationChild)
+{
+    // Items only move within their category
+    if (sourceParent != destinationParent || sourceRow < 0 || count <= 0
+            || sourceRow + count > rowCount(sourceParent)
+            || destinationChild < 0 || destinationChild > rowCount(sourceParent)) {
+        return false;
+    }
+
+    // Refused when the rows would not move at all
+    if (!beginMoveRows(sourceParent, sourceRow, sourceRow + count - 1,
+                       destinationParent, destinationChild)) {
+        return false;
+    }
+
+    // destinationChild counts the moved rows themselves
+    int to = destinationChild > sourceRow ? destinationChild - count : destinationChild;
+    if (!sourceParent.isValid()) {
+        m_categoryOrder.move(sourceRow, count, to);
+    } else {
+        m_categories[sourceParent.internalId()].items.move(sourceRow, count, to);
+    }
+    endMoveRows();
+
+    return true;
+}
+
+MenuModel::Id MenuModel::appendCategoryRow(const QString &label)
+{
+    Id id = m_nextId++;
+
+    Category category;
+    category.label = label;
+    m_categories.insert(id, category);
+    m_categoryOrder.append(id);
+
+    return id;
+}
+
+MenuModel::Item *MenuModel::appendItemRow(int category)
+{
+    Id categoryId = m_categoryOrder.at(category);
+    Id id = m_nextId++;
+
+    m_categories[categoryId].items.append(id);
+
+    Item &item = m_items[id];
+    item.category = categoryId;
+    return &item;
+}
+
+MenuModel::Category *MenuModel::categoryAt(int category)
+{
+    Id id = m_categoryOrder.at(category);
+    if (!id) {
+        return nullptr;
+    }
+
+    auto it = m_categories.find(id);
+    return it == m_categories.end() ? nullptr : &it.value();
+}
+
+const MenuModel::Category *MenuModel::categoryAt(int category) const
+{
+    Id id = m_categoryOrder.at(category);
+    if (!id) {
+        return nullptr;
+    }
+
+    auto it = m_categories.constFind(id);
+    return it == m_categories.constEnd() ? nullptr : &it.value();
+}
+
+MenuModel::Item *MenuModel::itemAt(int category, int item)
+{
+    Category *entry = categoryAt(category);
+    Id id = entry ? entry->items.at(item) : 0;
+    if (!id) {
+        return nullptr;
+    }
+
+    auto it = m_items.find(id);
+    return it == m_items.end() ? nullptr : &it.value();
+}
+
+const MenuModel::Item *MenuModel::itemAt(int category, int item) const
+{
+    const Category *entry = categoryAt(category);
+    Id id = entry ? entry->items.at(item) : 0;
+    if (!id) {
+        return nullptr;
+    }
+
+    auto it = m_items.constFind(id);
+    return it == m_items.constEnd() ? nullptr : &it.value();
+}
+
+void MenuModel::emitLabelsChanged(const QModelIndex &parent, int first, int last)
+{
+    emit dataChanged(index(first, 0, parent), index(last, 0, parent),
+                     QVector<int>() << Qt::DisplayRole << Qt::EditRole);
+}
+
+bool MenuModel::isValidCategory(int category) const
+{
+    return category >= 0 && category < m_categoryOrder.size();
+}
+
+bool MenuModel::isValidItem(int category, int item) const
+{
+    return item >= 0 && item < itemCount(category);
+}
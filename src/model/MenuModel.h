@@ -0,0 +1,162 @@
+#ifndef MENUMODEL_H
+#define MENUMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <functional>
+#include "PositionIndex.h"
+
+class CustomWidget;
+
+// Two-level menu catalog: categories are top-level rows, items are their
+// children. One model can back any number of MenuWidget views.
+//
+// Every category and item has an id that stays the same while rows are
+// inserted, removed or moved around it. Rows are found from ids (and ids
+// from rows) through a PositionIndex, so removing or moving a row costs
+// O(log n) however large the catalog.
+class MenuModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    // Builds the content widget of an item the first time a view needs it
+    typedef std::function<CustomWidget*()> ContentFactory;
+
+    // Stable id of a category or an item, also its model indexes'
+    // internalId(); never 0 and never reused
+    typedef PositionIndex::Id Id;
+
+    // One rename for setLabels(); item < 0 addresses the category itself
+    struct LabelChange {
+        LabelChange() : category(-1), item(-1) {}
+        LabelChange(int category, int item, const QString &label)
+            : category(category), item(item), label(label) {}
+
+        int category;
+        int item;
+        QString label;
+    };
+
+    enum Roles {
+        // MenuModel::ContentFactory stored for an item
+        ContentFactoryRole = Qt::UserRole + 1,
+
+        // QString shown by a CustomWidget when the item has no factory
+        // (used by catalogs that store content as data, not code)
+        ContentTextRole = Qt::UserRole + 2,
+
+        // QString naming the kind of widget that shows ContentTextRole,
+        // for content widget recycling (see MenuWidget::setContentRecycling())
+        ContentTypeRole = Qt::UserRole + 3,
+
+        // MenuModel::Id of the category or item
+        IdRole = Qt::UserRole + 4
+    };
+
+    explicit MenuModel(QObject *parent = nullptr);
+    ~MenuModel();
+
+    // Append a category and return its row
+    int appendCategory(const QString &label);
+
+    // Append several categories with a single rowsInserted() and return the
+    // row of the first one (-1 if labels is empty)
+    int appendCategories(const QStringList &labels);
+
+    // Append an item to a category and return its row (-1 if the category is invalid)
+    int appendItem(int category, const QString &label, const ContentFactory &factory = ContentFactory());
+
+    // Append several items with a single rowsInserted() and return the row of
+    // the first one (-1 if the category is invalid or labels is empty).
+    // Items without a matching entry in factories get no factory.
+    int appendItems(int category, const QStringList &labels,
+                    const QList<ContentFactory> &factories = QList<ContentFactory>());
+
+    // Same, for items whose content is plain text (see ContentTextRole),
+    // all of one content type
+    int appendTextItems(int category, const QStringList &labels, const QStringList &contents,
+                        const QString &contentType = QString());
+
+    int categoryCount() const;
+    int itemCount(int category) const;
+
+    // Convenience accessors (invalid indices return empty values)
+    QString categoryLabel(int category) const;
+    QString itemLabel(int category, int item) const;
+    ContentFactory itemFactory(int category, int item) const;
+
+    // Ids of a category or an item (0 for invalid indices), and the index
+    // of the category or item with an id (invalid if it was removed)
+    Id categoryId(int category) const;
+    Id itemId(int category, int item) const;
+    QModelIndex indexForId(Id id) const;
+
+    // Remove a category with its items, or an item (returns false for
+    // invalid indices)
+    bool removeCategory(int category);
+    bool removeItem(int category, int item);
+
+    // Move a category, or an item within its category, so it ends up at
+    // row to (returns false for invalid indices)
+    bool moveCategory(int from, int to);
+    bool moveItem(int category, int from, int to);
+
+    // Rename a category or an item (returns false for invalid indices)
+    bool setCategoryLabel(int category, const QString &label);
+    bool setItemLabel(int category, int item, const QString &label);
+
+    // Apply many renames at once and return the number of labels changed.
+    // dataChanged() is emitted once per run of adjacent changed rows
+    // instead of once per label; invalid entries are ignored.
+    int setLabels(const QVector<LabelChange> &changes);
+
+    // QAbstractItemModel interface
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                  const QModelIndex &destinationParent, int destinationChild) override;
+
+private:
+    struct Item {
+        QString label;
+        ContentFactory factory;
+        QString contentText;
+        QString contentType;
+        Id category;
+    };
+
+    struct Category {
+        QString label;
+        PositionIndex items;
+    };
+
+    Id appendCategoryRow(const QString &label);
+    Item *appendItemRow(int category);
+    Category *categoryAt(int category);
+    const Category *categoryAt(int category) const;
+    Item *itemAt(int category, int item);
+    const Item *itemAt(int category, int item) const;
+    void emitLabelsChanged(const QModelIndex &parent, int first, int last);
+    bool isValidCategory(int category) const;
+    bool isValidItem(int category, int item) const;
+
+    // Rows by id, and the order of the categories; each category orders
+    // its own items
+    QHash<Id, Category> m_categories;
+    QHash<Id, Item> m_items;
+    PositionIndex m_categoryOrder;
+    Id m_nextId;
+};
+
+Q_DECLARE_METATYPE(MenuModel::ContentFactory)
+
+#endif // MENUMODEL_H
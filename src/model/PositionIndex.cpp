@@ -0,0 +1,253 @@
+#include "PositionIndex.h"
+
+PositionIndex::PositionIndex()
+    : m_root(-1)
+    , m_seed(0x9e3779b9u)
+{
+}
+
+int PositionIndex::size() const
+{
+    return sizeOf(m_root);
+}
+
+bool PositionIndex::contains(Id id) const
+{
+    return m_slots.contains(id);
+}
+
+PositionIndex::Id PositionIndex::at(int position) const
+{
+    if (position < 0 || position >= size()) {
+        return 0;
+    }
+
+    int node = m_root;
+    while (node >= 0) {
+        const Node &current = m_nodes.at(node);
+        int leftSize = sizeOf(current.left);
+        if (position < leftSize) {
+            node = current.left;
+        } else if (position == leftSize) {
+            return current.id;
+        } else {
+            position -= leftSize + 1;
+            node = current.right;
+        }
+    }
+    return 0;
+}
+
+int PositionIndex::positionOf(Id id) const
+{
+    int node = m_slots.value(id, -1);
+    if (node < 0) {
+        return -1;
+    }
+
+    // Count what precedes the node on the way up to the root
+    int position = sizeOf(m_nodes.at(node).left);
+    while (m_nodes.at(node).parent >= 0) {
+        int parent = m_nodes.at(node).parent;
+        if (m_nodes.at(parent).right == node) {
+            position += sizeOf(m_nodes.at(parent).left) + 1;
+        }
+        node = parent;
+    }
+    return position;
+}
+
+QVector<PositionIndex::Id> PositionIndex::ids() const
+{
+    QVector<Id> result;
+    result.reserve(size());
+    collect(m_root, &result);
+    return result;
+}
+
+void PositionIndex::insert(int position, Id id)
+{
+    if (m_slots.contains(id)) {
+        return;
+    }
+
+    position = qBound(0, position, size());
+
+    int left, right;
+    split(m_root, position, &left, &right);
+    setRoot(merge(merge(left, newNode(id)), right));
+}
+
+void PositionIndex::append(Id id)
+{
+    insert(size(), id);
+}
+
+QVector<PositionIndex::Id> PositionIndex::remove(int first, int count)
+{
+    QVector<Id> removed;
+    first = qBound(0, first, size());
+    count = qBound(0, count, size() - first);
+    if (count == 0) {
+        return removed;
+    }
+
+    int left, middle, right;
+    split(m_root, first, &left, &middle);
+    split(middle, count, &middle, &right);
+    setRoot(merge(left, right));
+
+    collect(middle, &removed);
+    for (Id id : removed) {
+        m_freeSlots.append(m_slots.take(id));
+    }
+    return removed;
+}
+
+void PositionIndex::move(int first, int count, int to)
+{
+    if (first < 0 || count <= 0 || first + count > size()) {
+        return;
+    }
+
+    to = qBound(0, to, size() - count);
+    if (to == first) {
+        return;
+    }
+
+    // Cut the run out, then splice it back in at its new position
+    int left, middle, right;
+    split(m_root, first, &left, &middle);
+    split(middle, count, &middle, &right);
+
+    int rest = merge(left, right);
+    split(rest, to, &left, &right);
+    setRoot(merge(merge(left, middle), right));
+}
+
+void PositionIndex::clear()
+{
+    m_nodes.clear();
+    m_freeSlots.clear();
+    m_slots.clear();
+    m_root = -1;
+}
+
+int PositionIndex::sizeOf(int node) const
+{
+    return node < 0 ? 0 : m_nodes.at(node).size;
+}
+
+void PositionIndex::update(int node)
+{
+    Node &current = m_nodes[node];
+    current.size = sizeOf(current.left) + sizeOf(current.right) + 1;
+    if (current.left >= 0) {
+        m_nodes[current.left].parent = node;
+    }
+    if (current.right >= 0) {
+        m_nodes[current.right].parent = node;
+    }
+}
+
+void PositionIndex::split(int node, int count, int *left, int *right)
+{
+    // The first count nodes go left, the rest right
+    if (node < 0) {
+        *left = -1;
+        *right = -1;
+        return;
+    }
+
+    int leftSize = sizeOf(m_nodes.at(node).left);
+    if (count <= leftSize) {
+        int subtreeRight;
+        split(m_nodes.at(node).left, count, left, &subtreeRight);
+        m_nodes[node].left = subtreeRight;
+        *right = node;
+    } else {
+        int subtreeLeft;
+        split(m_nodes.at(node).right, count - leftSize - 1, &subtreeLeft, right);
+        m_nodes[node].right = subtreeLeft;
+        *left = node;
+    }
+    update(node);
+
+    // Either half may become a root
+    if (*left >= 0) {
+        m_nodes[*left].parent = -1;
+    }
+    if (*right >= 0) {
+        m_nodes[*right].parent = -1;
+    }
+}
+
+int PositionIndex::merge(int left, int right)
+{
+    // Every node of left precedes every node of right
+    if (left < 0) {
+        return right;
+    }
+    if (right < 0) {
+        return left;
+    }
+
+    if (m_nodes.at(left).priority > m_nodes.at(right).priority) {
+        int merged = merge(m_nodes.at(left).right, right);
+        m_nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+
+    int merged = merge(left, m_nodes.at(right).left);
+    m_nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+int PositionIndex::newNode(Id id)
+{
+    // xorshift32, only used to keep the tree balanced
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node node;
+    node.id = id;
+    node.priority = m_seed;
+    node.size = 1;
+    node.left = -1;
+    node.right = -1;
+    node.parent = -1;
+
+    int slot;
+    if (!m_freeSlots.isEmpty()) {
+        slot = m_freeSlots.takeLast();
+        m_nodes[slot] = node;
+    } else {
+        slot = m_nodes.size();
+        m_nodes.append(node);
+    }
+
+    m_slots.insert(id, slot);
+    return slot;
+}
+
+void PositionIndex::collect(int node, QVector<Id> *ids) const
+{
+    if (node < 0) {
+        return;
+    }
+
+    collect(m_nodes.at(node).left, ids);
+    ids->append(m_nodes.at(node).id);
+    collect(m_nodes.at(node).right, ids);
+}
+
+void PositionIndex::setRoot(int node)
+{
+    m_root = node;
+    if (m_root >= 0) {
+        m_nodes[m_root].parent = -1;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+// Ordered list of ids kept as an implicit treap (a randomly balanced
+// tree ordered by position, each node counting the nodes below it).
+// The id at a position, the position of an id, and inserting, removing
+// or moving a run of ids all take O(log n), without renumbering the
+// ids that come after.
+class PositionIndex
+{
+public:
+    typedef quintptr Id;
+
+    PositionIndex();
+
+    int size() const;
+    bool contains(Id id) const;
+
+    // Id at position, 0 if out of range
+    Id at(int position) const;
+
+    // Position of id, -1 if absent
+    int positionOf(Id id) const;
+
+    // All ids in order
+    QVector<Id> ids() const;
+
+    // Insert id before position (clamped to [0, size()]); ids already
+    // present are ignored
+    void insert(int position, Id id);
+    void append(Id id);
+
+    // Remove count ids starting at first and return them
+    QVector<Id> remove(int first, int count = 1);
+
+    // Move count ids starting at first so the first of them ends up at
+    // position to
+    void move(int first, int count, int to);
+
+    void clear();
+
+private:
+    struct Node {
+        Id id;
+        quint32 priority;
+        int size;
+        int left;
+        int right;
+        int parent;
+    };
+
+    int sizeOf(int node) const;
+    void update(int node);
+    void split(int node, int count, int *left, int *right);
+    int merge(int left, int right);
+    int newNode(Id id);
+    void collect(int node, QVector<Id> *ids) const;
+    void setRoot(int node);
+
+    // Nodes are addressed by their slot; freed slots are reused
+    QVector<Node> m_nodes;
+    QVector<int> m_freeSlots;
+    QHash<Id, int> m_slots;
+    int m_root;
+    quint32 m_seed;
+};
+
+#endif // POSITIONINDEX_H
@@ -0,0 +1,701 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+
+namespace {
+
+// Labels scored per search; bounds the query time on huge catalogs
+const int MaxCandidates = 4096;
+
+// Rarest query trigrams whose postings seed the candidates
+const int MaxSeedTrigrams = 3;
+
+// Scores of subsequence matches start here, typo matches stay below
+const int SubsequenceBase = 1000;
+
+QString foldLabel(const QString &label)
+{
+    return label.simplified().toCaseFolded();
+}
+
+// Runs of letters and digits, each word once
+QStringList splitWords(const QString &key)
+{
+    QStringList words;
+    int start = -1;
+
+    for (int i = 0; i <= key.size(); ++i) {
+        bool inWord = i < key.size() && key.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            words.append(key.mid(start, i - start));
+            start = -1;
+        }
+    }
+
+    words.removeDuplicates();
+    return words;
+}
+
+// Distinct trigrams of key, sorted
+QVector<quint64> trigramsOf(const QString &key)
+{
+    QVector<quint64> trigrams;
+    if (key.size() < 3) {
+        return trigrams;
+    }
+
+    trigrams.reserve(key.size() - 2);
+    for (int i = 0; i + 2 < key.size(); ++i) {
+        trigrams.append(quint64(key.at(i).unicode()) << 32
+                        | quint64(key.at(i + 1).unicode()) << 16
+                        | quint64(key.at(i + 2).unicode()));
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+// Greedy in-order match of the query characters in key; consecutive
+// characters and word starts score higher. -1 if query is not a
+// subsequence of key.
+int subsequenceScore(const QString &query, const QString &key)
+{
+    int score = 0;
+    int matched = 0;
+    int previous = -2;
+
+    for (int i = 0; i < key.size() && matched < query.size(); ++i) {
+        if (key.at(i) != query.at(matched)) {
+            continue;
+        }
+
+        score += 10;
+        if (i == previous + 1) {
+            score += 15;
+        }
+        if (i == 0 || !key.at(i - 1).isLetterOrNumber()) {
+            score += 20;
+        }
+
+        previous = i;
+        ++matched;
+    }
+
+    if (matched < query.size()) {
+        return -1;
+    }
+
+    // Prefer shorter labels among equal matches
+    return qMax(0, score - (key.size() - query.size()) / 4);
+}
+
+int matchScore(const QString &query, const QVector<quint64> &queryTrigrams, const QString &key)
+{
+    int score = subsequenceScore(query, key);
+    if (score >= 0) {
+        score += SubsequenceBase;
+        if (key.startsWith(query)) {
+            score += 100;
+        }
+        if (key.size() == query.size()) {
+            score += 100;
+        }
+        return score;
+    }
+
+    // Misspelled queries: enough trigrams in common
+    if (queryTrigrams.isEmpty()) {
+        return 0;
+    }
+
+    QVector<quint64> keyTrigrams = trigramsOf(key);
+    int shared = 0;
+    int q = 0;
+    int k = 0;
+    while (q < queryTrigrams.size() && k < keyTrigrams.size()) {
+        if (queryTrigrams.at(q) < keyTrigrams.at(k)) {
+            ++q;
+        } else if (keyTrigrams.at(k) < queryTrigrams.at(q)) {
+            ++k;
+        } else {
+            ++shared;
+            ++q;
+            ++k;
+        }
+    }
+
+    if (shared == 0 || shared * 2 < queryTrigrams.size()) {
+        return 0;
+    }
+
+    return (SubsequenceBase / 2) * shared / queryTrigrams.size();
+}
+
+}
+
+SearchIndex::SearchIndex(QObject *parent)
+    : QObject(parent)
+    , m_dirty(true)
+    , m_livePostings(0)
+    , m_stalePostings(0)
+    , m_removedEntries(0)
+    , m_generation(0)
+{
+}
+
+SearchIndex::~SearchIndex()
+{
+}
+
+void SearchIndex::setModel(QAbstractItemModel *model)
+{
+    if (model == m_model) {
+        return;
+    }
+
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+
+    m_model = model;
+
+    if (m_model) {
+        // Growth, removal, moves and relabeling are applied incrementally
+        connect(m_model.data(), &QAbstractItemModel::rowsInserted,
+                this, &SearchIndex::onRowsInserted);
+        connect(m_model.data(), &QAbstractItemModel::rowsRemoved,
+                this, &SearchIndex::onRowsRemoved);
+        connect(m_model.data(), &QAbstractItemModel::rowsMoved,
+                this, &SearchIndex::onRowsMoved);
+        connect(m_model.data(), &QAbstractItemModel::dataChanged,
+                this, &SearchIndex::onDataChanged);
+
+        // Anything else may reorder every row, rebuild before the next search
+        connect(m_model.data(), &QAbstractItemModel::layoutChanged,
+                this, &SearchIndex::invalidate);
+        connect(m_model.data(), &QAbstractItemModel::modelReset,
+                this, &SearchIndex::invalidate);
+    }
+
+    invalidate();
+}
+
+QAbstractItemModel *SearchIndex::model() const
+{
+    return m_model;
+}
+
+int SearchIndex::count() const
+{
+    return m_dirty ? 0 : m_entries.size() - m_removedEntries;
+}
+
+void SearchIndex::invalidate()
+{
+    m_dirty = true;
+}
+
+void SearchIndex::clear()
+{
+    m_entries.clear();
+    m_categoryEntries.clear();
+    m_itemEntries.clear();
+    m_trie.clear();
+    m_wordEntries.clear();
+    m_trigrams.clear();
+    m_seen.clear();
+    m_livePostings = 0;
+    m_stalePostings = 0;
+    m_removedEntries = 0;
+
+    // Root node
+    TrieNode root = { 0, -1, -1, -1, 0 };
+    m_trie.append(root);
+}
+
+void SearchIndex::ensureBuilt()
+{
+    if (!m_dirty) {
+        return;
+    }
+
+    clear();
+    m_dirty = false;
+
+    if (m_model && m_model->rowCount() > 0) {
+        appendCategories(0, m_model->rowCount() - 1);
+    }
+}
+
+void SearchIndex::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    // A pending rebuild picks the rows up anyway
+    if (m_dirty) {
+        return;
+    }
+
+    if (!parent.isValid()) {
+        if (first != m_categoryEntries.size()) {
+            invalidate();
+            return;
+        }
+
+        appendCategories(first, last);
+        return;
+    }
+
+    // Only categories and their direct children are indexed
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    int category = parent.row();
+    if (category < 0 || category >= m_itemEntries.size()) {
+        return;
+    }
+
+    if (first != m_itemEntries.at(category).size()) {
+        invalidate();
+        return;
+    }
+
+    appendItems(category, first, last);
+}
+
+void SearchIndex::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (m_dirty || parent.parent().isValid()) {
+        return;
+    }
+
+    int count = last - first + 1;
+
+    if (!parent.isValid()) {
+        if (first < 0 || last >= m_categoryEntries.size()) {
+            invalidate();
+            return;
+        }
+
+        // A category takes its items along
+        for (int category = first; category <= last; ++category) {
+            removeEntry(m_categoryEntries.at(category));
+            for (int id : m_itemEntries.at(category)) {
+                removeEntry(id);
+            }
+        }
+        m_categoryEntries.remove(first, count);
+        m_itemEntries.remove(first, count);
+        renumber(m_categoryEntries, first, m_categoryEntries.size() - 1);
+    } else {
+        int category = parent.row();
+        if (category < 0 || category >= m_itemEntries.size()
+                || first < 0 || last >= m_itemEntries.at(category).size()) {
+            invalidate();
+            return;
+        }
+
+        QVector<int> &items = m_itemEntries[category];
+        for (int item = first; item <= last; ++item) {
+            removeEntry(items.at(item));
+        }
+        items.remove(first, count);
+        renumber(items, first, items.size() - 1);
+    }
+
+    dropStalePostings();
+}
+
+void SearchIndex::onRowsMoved(const QModelIndex &parent, int start, int end,
+                              const QModelIndex &destination, int row)
+{
+    if (m_dirty) {
+        return;
+    }
+
+    // Items moving to another category change their parent entry
+    if (parent != destination) {
+        invalidate();
+        return;
+    }
+
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    QVector<int> *ids = &m_categoryEntries;
+    if (parent.isValid()) {
+        int category = parent.row();
+        if (category < 0 || category >= m_itemEntries.size()) {
+            invalidate();
+            return;
+        }
+        ids = &m_itemEntries[category];
+    }
+
+    if (start < 0 || end >= ids->size() || row < 0 || row > ids->size()) {
+        invalidate();
+        return;
+    }
+
+    // row is counted before the move, only the rows in between shift
+    int first = qMin(start, row);
+    int last = qMax(end, row - 1);
+    if (row > end + 1) {
+        std::rotate(ids->begin() + start, ids->begin() + end + 1, ids->begin() + row);
+    } else if (row < start) {
+        std::rotate(ids->begin() + row, ids->begin() + start, ids->begin() + end + 1);
+    } else {
+        return;
+    }
+
+    // Category rows move their item lists along
+    if (!parent.isValid()) {
+        if (row > end + 1) {
+            std::rotate(m_itemEntries.begin() + start, m_itemEntries.begin() + end + 1,
+                        m_itemEntries.begin() + row);
+        } else {
+            std::rotate(m_itemEntries.begin() + row, m_itemEntries.begin() + start,
+                        m_itemEntries.begin() + end + 1);
+        }
+    }
+
+    renumber(*ids, first, last);
+}
+
+void SearchIndex::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                const QVector<int> &roles)
+{
+    if (m_dirty || !m_model || !topLeft.isValid() || !bottomRight.isValid()) {
+        return;
+    }
+
+    // Only labels are indexed
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole)) {
+        return;
+    }
+
+    QModelIndex parent = topLeft.parent();
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    if (!parent.isValid()) {
+        int last = qMin(bottomRight.row(), m_categoryEntries.size() - 1);
+        for (int row = topLeft.row(); row <= last; ++row) {
+            relabelEntry(m_categoryEntries.at(row), m_model->index(row, 0).data(Qt::DisplayRole).toString());
+        }
+        return;
+    }
+
+    int category = parent.row();
+    if (category < 0 || category >= m_itemEntries.size()) {
+        return;
+    }
+
+    const QVector<int> &items = m_itemEntries.at(category);
+    int last = qMin(bottomRight.row(), items.size() - 1);
+    for (int row = topLeft.row(); row <= last; ++row) {
+        relabelEntry(items.at(row), m_model->index(row, 0, parent).data(Qt::DisplayRole).toString());
+    }
+}
+
+void SearchIndex::appendCategories(int first, int last)
+{
+    for (int category = first; category <= last; ++category) {
+        QModelIndex categoryIndex = m_model->index(category, 0);
+        m_categoryEntries.append(addEntry(-1, category, categoryIndex.data(Qt::DisplayRole).toString()));
+        m_itemEntries.append(QVector<int>());
+
+        // A category may arrive with its items already in the model
+        int itemCount = m_model->rowCount(categoryIndex);
+        if (itemCount > 0) {
+            appendItems(category, 0, itemCount - 1);
+        }
+    }
+}
+
+void SearchIndex::appendItems(int category, int first, int last)
+{
+    QModelIndex categoryIndex = m_model->index(category, 0);
+    int parent = m_categoryEntries.at(category);
+    QVector<int> &items = m_itemEntries[category];
+    items.reserve(last + 1);
+
+    for (int item = first; item <= last; ++item) {
+        QString label = m_model->index(item, 0, categoryIndex).data(Qt::DisplayRole).toString();
+        items.append(addEntry(parent, item, label));
+    }
+}
+
+int SearchIndex::addEntry(int parent, int row, const QString &label)
+{
+    int id = m_entries.size();
+
+    // Categories have no parent to refer to
+    Entry entry;
+    entry.parent = parent < 0 ? id : parent;
+    entry.row = row;
+    entry.postings = 0;
+    m_entries.append(entry);
+    m_seen.append(0);
+
+    indexKey(id, foldLabel(label));
+    return id;
+}
+
+void SearchIndex::relabelEntry(int id, const QString &label)
+{
+    QString key = foldLabel(label);
+    Entry &entry = m_entries[id];
+    if (entry.key == key) {
+        return;
+    }
+
+    m_stalePostings += entry.postings;
+    m_livePostings -= entry.postings;
+    indexKey(id, key);
+
+    dropStalePostings();
+}
+
+void SearchIndex::removeEntry(int id)
+{
+    // Its postings stay behind, searches skip it
+    Entry &entry = m_entries[id];
+    m_stalePostings += entry.postings;
+    m_livePostings -= entry.postings;
+    entry.parent = -1;
+    entry.postings = 0;
+    entry.key.clear();
+    ++m_removedEntries;
+}
+
+void SearchIndex::renumber(const QVector<int> &ids, int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        m_entries[ids.at(row)].row = row;
+    }
+}
+
+void SearchIndex::dropStalePostings()
+{
+    // Searches would mostly score dead candidates, start over
+    if (m_stalePostings > m_livePostings) {
+        invalidate();
+    }
+}
+
+void SearchIndex::indexKey(int id, const QString &key)
+{
+    const QStringList words = splitWords(key);
+    for (const QString &word : words) {
+        insertWord(word, id);
+    }
+
+    const QVector<quint64> trigrams = trigramsOf(key);
+    for (quint64 trigram : trigrams) {
+        m_trigrams[trigram].append(id);
+    }
+
+    Entry &entry = m_entries[id];
+    entry.key = key;
+    entry.postings = words.size() + trigrams.size();
+    m_livePostings += entry.postings;
+}
+
+int SearchIndex::findChild(int node, ushort ch) const
+{
+    for (int child = m_trie.at(node).firstChild; child >= 0; child = m_trie.at(child).nextSibling) {
+        if (m_trie.at(child).ch == ch) {
+            return child;
+        }
+    }
+    return -1;
+}
+
+void SearchIndex::insertWord(const QString &word, int id)
+{
+    int node = 0;
+    ++m_trie[node].postings;
+
+    for (QChar c : word) {
+        int child = findChild(node, c.unicode());
+        if (child < 0) {
+            // Appending may reallocate, so nodes are addressed by index
+            TrieNode added = { c.unicode(), -1, m_trie.at(node).firstChild, -1, 0 };
+            child = m_trie.size();
+            m_trie.append(added);
+            m_trie[node].firstChild = child;
+        }
+
+        node = child;
+        ++m_trie[node].postings;
+    }
+
+    if (m_trie.at(node).word < 0) {
+        m_trie[node].word = m_wordEntries.size();
+        m_wordEntries.append(QVector<int>());
+    }
+
+    m_wordEntries[m_trie.at(node).word].append(id);
+}
+
+int SearchIndex::findNode(const QString &prefix) const
+{
+    int node = 0;
+    for (int i = 0; i < prefix.size() && node >= 0; ++i) {
+        node = findChild(node, prefix.at(i).unicode());
+    }
+    return node;
+}
+
+void SearchIndex::addCandidate(int id, QVector<int> &candidates)
+{
+    if (m_seen.at(id) != m_generation) {
+        m_seen[id] = m_generation;
+        candidates.append(id);
+    }
+}
+
+void SearchIndex::collectPrefix(int node, QVector<int> &candidates)
+{
+    // Breadth first, so whole-word matches come before longer words
+    QVector<int> queue;
+    queue.append(node);
+
+    for (int head = 0; head < queue.size() && candidates.size() < MaxCandidates; ++head) {
+        const TrieNode &current = m_trie.at(queue.at(head));
+
+        if (current.word >= 0) {
+            const QVector<int> &ids = m_wordEntries.at(current.word);
+            for (int i = 0; i < ids.size() && candidates.size() < MaxCandidates; ++i) {
+                addCandidate(ids.at(i), candidates);
+            }
+        }
+
+        for (int child = current.firstChild; child >= 0; child = m_trie.at(child).nextSibling) {
+            queue.append(child);
+        }
+    }
+}
+
+void SearchIndex::collectTrigrams(const QString &key, QVector<int> &candidates)
+{
+    QVector<const QVector<int>*> postings;
+
+    const QVector<quint64> trigrams = trigramsOf(key);
+    for (quint64 trigram : trigrams) {
+        QHash<quint64, QVector<int> >::const_iterator it = m_trigrams.constFind(trigram);
+        if (it != m_trigrams.constEnd()) {
+            postings.append(&it.value());
+        }
+    }
+
+    // A typo only breaks the trigrams around it, the rarest intact
+    // ones still point at the intended label
+    std::sort(postings.begin(), postings.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+
+    for (int i = 0; i < postings.size() && i < MaxSeedTrigrams; ++i) {
+        const QVector<int> &ids = *postings.at(i);
+        for (int j = 0; j < ids.size() && candidates.size() < MaxCandidates; ++j) {
+            addCandidate(ids.at(j), candidates);
+        }
+    }
+}
+
+QVector<SearchIndex::Match> SearchIndex::search(const QString &query, int maxResults)
+{
+    QVector<Match> matches;
+
+    ensureBuilt();
+
+    QString key = foldLabel(query);
+    if (!m_model || key.isEmpty() || maxResults <= 0) {
+        return matches;
+    }
+
+    // New stamp for this search; on wrap-around forget all old stamps
+    if (++m_generation == 0) {
+        m_seen.fill(0);
+        m_generation = 1;
+    }
+
+    QVector<int> candidates;
+
+    // Labels with a word starting like the most selective query word
+    int bestNode = -1;
+    const QStringList words = splitWords(key);
+    for (const QString &word : words) {
+        int node = findNode(word);
+        if (node < 0) {
+            bestNode = -1;
+            break;
+        }
+        if (bestNode < 0 || m_trie.at(node).postings < m_trie.at(bestNode).postings) {
+            bestNode = node;
+        }
+    }
+    if (bestNode >= 0) {
+        collectPrefix(bestNode, candidates);
+    }
+
+    // Mid-word and misspelled matches
+    collectTrigrams(key, candidates);
+
+    struct Scored {
+        int score;
+        int id;
+    };
+
+    const QVector<quint64> queryTrigrams = trigramsOf(key);
+    QVector<Scored> scored;
+    scored.reserve(candidates.size());
+    for (int id : candidates) {
+        if (m_entries.at(id).parent < 0) {
+            continue;
+        }
+
+        int score = matchScore(key, queryTrigrams, m_entries.at(id).key);
+        if (score > 0) {
+            Scored result = { score, id };
+            scored.append(result);
+        }
+    }
+
+    int resultCount = qMin(maxResults, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + resultCount, scored.end(),
+                      [this](const Scored &a, const Scored &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (m_entries.at(a.id).key.size() != m_entries.at(b.id).key.size()) {
+            return m_entries.at(a.id).key.size() < m_entries.at(b.id).key.size();
+        }
+        return a.id < b.id;
+    });
+
+    matches.reserve(resultCount);
+    for (int i = 0; i < resultCount; ++i) {
+        int id = scored.at(i).id;
+        const Entry &entry = m_entries.at(id);
+        bool isCategory = entry.parent == id;
+
+        Match match;
+        match.category = m_entries.at(entry.parent).row;
+        match.item = isCategory ? -1 : entry.row;
+
+        QModelIndex index = m_model->index(match.category, 0);
+        if (!isCategory) {
+            index = m_model->index(match.item, 0, index);
+        }
+        match.score = scored.at(i).score;
+        match.label = index.data(Qt::DisplayRole).toString();
+        matches.append(match);
+    }
+
+    return matches;
+}
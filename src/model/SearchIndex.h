@@ -0,0 +1,115 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QObject>
+#include <QAbstractItemModel>
+#include <QPointer>
+#include <QVector>
+#include <QHash>
+#include <QString>
+
+// Type-ahead index over the category and item labels of a menu model.
+// The words of every label go into a prefix trie ("gen" finds
+// "General"), and their character trigrams into an inverted index so
+// that mid-word and misspelled queries still find candidates. Candidates
+// are ranked with a fuzzy subsequence score.
+//
+// The index follows its model: inserted, removed and moved rows and
+// relabels are applied incrementally, at a cost in the size of the
+// affected category (plus the category count for category rows); a
+// model reset or layout change rebuilds it on the next search.
+class SearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Match {
+        int category;
+        int item;       // -1 when the category itself matched
+        int score;
+        QString label;
+    };
+
+    explicit SearchIndex(QObject *parent = nullptr);
+    ~SearchIndex();
+
+    void setModel(QAbstractItemModel *model);
+    QAbstractItemModel *model() const;
+
+    // Best matches for query, highest score first
+    QVector<Match> search(const QString &query, int maxResults = 10);
+
+    // Number of indexed labels (categories and items)
+    int count() const;
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsMoved(const QModelIndex &parent, int start, int end,
+                     const QModelIndex &destination, int row);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                       const QVector<int> &roles);
+    void invalidate();
+
+private:
+    // Items refer to their category's entry, so moving or removing
+    // categories only renumbers the category entries
+    struct Entry {
+        int parent;     // Entry of the category, the entry itself for a
+                        // category, -1 once removed
+        int row;        // Row in the category, or of the category
+        QString key;    // Folded label, what queries are matched against
+        int postings;   // Trie and trigram postings added for key
+    };
+
+    // Left-child, right-sibling trie over label words
+    struct TrieNode {
+        ushort ch;
+        int firstChild;
+        int nextSibling;
+        int word;       // Index into m_wordEntries, -1 if no word ends here
+        int postings;   // Postings of all words below, to pick selective prefixes
+    };
+
+    void ensureBuilt();
+    void clear();
+    void appendCategories(int first, int last);
+    void appendItems(int category, int first, int last);
+    int addEntry(int parent, int row, const QString &label);
+    void relabelEntry(int id, const QString &label);
+    void removeEntry(int id);
+    void renumber(const QVector<int> &ids, int first, int last);
+    void dropStalePostings();
+    void indexKey(int id, const QString &key);
+
+    void insertWord(const QString &word, int id);
+    int findNode(const QString &prefix) const;
+    int findChild(int node, ushort ch) const;
+    void collectPrefix(int node, QVector<int> &candidates);
+    void collectTrigrams(const QString &key, QVector<int> &candidates);
+    void addCandidate(int id, QVector<int> &candidates);
+
+    QPointer<QAbstractItemModel> m_model;
+    bool m_dirty;
+
+    QVector<Entry> m_entries;
+    QVector<int> m_categoryEntries;
+    QVector<QVector<int> > m_itemEntries;
+
+    QVector<TrieNode> m_trie;
+    QVector<QVector<int> > m_wordEntries;
+    QHash<quint64, QVector<int> > m_trigrams;
+
+    // Relabels and removals leave the old postings behind; they are
+    // filtered out by scoring and dropped by a rebuild once they
+    // outnumber live ones
+    int m_livePostings;
+    int m_stalePostings;
+    int m_removedEntries;
+
+    // Per-entry stamp of the last search that collected it
+    QVector<quint32> m_seen;
+    quint32 m_generation;
+};
+
+#endif // SEARCHINDEX_H
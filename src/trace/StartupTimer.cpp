@@ -0,0 +1,157 @@
+#include "StartupTimer.h"
+
+#include <QEvent>
+#include <QFile>
+#include <QTimer>
+#include <QWidget>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Age of the process in milliseconds, -1 if unknown. Linux only: the
+// start time in /proc/self/stat against the uptime, both since boot.
+qint64 processAgeMs()
+{
+#ifdef Q_OS_LINUX
+    QFile stat(QStringLiteral("/proc/self/stat"));
+    QFile uptime(QStringLiteral("/proc/uptime"));
+    if (!stat.open(QIODevice::ReadOnly) || !uptime.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // The command name may hold spaces, fields are counted after it
+    QByteArray statLine = stat.readAll();
+    int nameEnd = statLine.lastIndexOf(')');
+    if (nameEnd < 0) {
+        return -1;
+    }
+    QList<QByteArray> fields = statLine.mid(nameEnd + 2).split(' ');
+
+    // Field 22, starttime, is the 20th after the name
+    const int StartTimeField = 19;
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (fields.size() <= StartTimeField || ticksPerSecond <= 0) {
+        return -1;
+    }
+
+    double startSeconds = fields.at(StartTimeField).toDouble() / ticksPerSecond;
+    double uptimeSeconds = uptime.readAll().split(' ').value(0).toDouble();
+    if (uptimeSeconds <= 0 || startSeconds > uptimeSeconds) {
+        return -1;
+    }
+    return qint64((uptimeSeconds - startSeconds) * 1000);
+#else
+    return -1;
+#endif
+}
+
+}
+
+StartupTimer::StartupTimer(QObject *parent)
+    : QObject(parent)
+    , m_processStartMs(processAgeMs())
+    , m_firstPaintMs(-1)
+    , m_interactiveMs(-1)
+    , m_interactivePending(false)
+{
+    m_clock.start();
+}
+
+StartupTimer::~StartupTimer()
+{
+    if (m_window) {
+        m_window->removeEventFilter(this);
+    }
+}
+
+void StartupTimer::watchFirstPaint(QWidget *window)
+{
+    if (!window || m_firstPaintMs >= 0) {
+        return;
+    }
+
+    if (m_window) {
+        m_window->removeEventFilter(this);
+    }
+    m_window = window;
+    m_window->installEventFilter(this);
+}
+
+void StartupTimer::markInteractive()
+{
+    if (m_interactiveMs >= 0) {
+        return;
+    }
+
+    // Queued behind whatever the app has scheduled so far
+    QTimer::singleShot(0, this, &StartupTimer::recordInteractive);
+}
+
+qint64 StartupTimer::processStartMs() const
+{
+    return m_processStartMs;
+}
+
+qint64 StartupTimer::firstPaintMs() const
+{
+    return m_firstPaintMs;
+}
+
+qint64 StartupTimer::interactiveMs() const
+{
+    return m_interactiveMs;
+}
+
+QString StartupTimer::report() const
+{
+    QString origin = m_processStartMs >= 0 ? QStringLiteral("process start") : QStringLiteral("main()");
+    return QString("startup (ms since %1): main() %2, first paint %3, interactive %4")
+            .arg(origin)
+            .arg(qMax<qint64>(0, m_processStartMs))
+            .arg(m_firstPaintMs)
+            .arg(m_interactiveMs);
+}
+
+bool StartupTimer::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_window && event->type() == QEvent::Paint && m_firstPaintMs < 0) {
+        m_firstPaintMs = sinceStart();
+        m_window->removeEventFilter(this);
+
+        if (m_interactivePending) {
+            QTimer::singleShot(0, this, &StartupTimer::recordInteractive);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StartupTimer::recordInteractive()
+{
+    if (m_interactiveMs >= 0) {
+        return;
+    }
+
+    // Not usable before it is on screen
+    if (m_window && m_firstPaintMs < 0) {
+        m_interactivePending = true;
+        return;
+    }
+
+    m_interactiveMs = sinceStart();
+    checkFinished();
+}
+
+qint64 StartupTimer::sinceStart() const
+{
+    return qMax<qint64>(0, m_processStartMs) + m_clock.elapsed();
+}
+
+void StartupTimer::checkFinished()
+{
+    if (m_firstPaintMs >= 0 && m_interactiveMs >= 0) {
+        emit finished();
+    }
+}
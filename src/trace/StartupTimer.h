@@ -0,0 +1,60 @@
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+
+class QWidget;
+
+// Measures process start -> first paint -> fully interactive. Create it
+// first thing in main(); times are in milliseconds since the process
+// started where the OS tells (Linux), since construction otherwise.
+class StartupTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupTimer(QObject *parent = nullptr);
+    ~StartupTimer();
+
+    // Records the first paint of window
+    void watchFirstPaint(QWidget *window);
+
+    // The app is usable; recorded when the event loop next gets to run,
+    // after the work queued so far, and never before the first paint
+    void markInteractive();
+
+    // Process start to construction, -1 if unknown
+    qint64 processStartMs() const;
+
+    // -1 until recorded
+    qint64 firstPaintMs() const;
+    qint64 interactiveMs() const;
+
+    // One line with the three times
+    QString report() const;
+
+signals:
+    // Both times are recorded
+    void finished();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void recordInteractive();
+
+private:
+    qint64 sinceStart() const;
+    void checkFinished();
+
+    QElapsedTimer m_clock;
+    qint64 m_processStartMs;
+    qint64 m_firstPaintMs;
+    qint64 m_interactiveMs;
+    bool m_interactivePending;
+    QPointer<QWidget> m_window;
+};
+
+#endif // STARTUPTIMER_H
@@ -0,0 +1,143 @@
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QVector>
+
+namespace {
+
+const int DefaultCapacity = 65536;
+
+struct Event {
+    const char *name;
+    const char *category;
+    qint64 start;
+    qint64 duration;
+    quintptr thread;
+};
+
+// Allocated when tracing is first enabled, never grows while recording
+QVector<Event> g_events;
+int g_capacity = DefaultCapacity;
+
+// Total events recorded, the next slot is g_recorded % capacity
+std::atomic<qint64> g_recorded(0);
+
+QElapsedTimer g_clock;
+
+}
+
+std::atomic<bool> Trace::s_enabled(false);
+
+void Trace::setEnabled(bool enabled)
+{
+    if (enabled) {
+        if (!g_clock.isValid()) {
+            g_clock.start();
+        }
+        if (g_events.size() != g_capacity) {
+            g_events.resize(g_capacity);
+        }
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::setCapacity(int events)
+{
+    if (events < 1) {
+        return;
+    }
+
+    g_capacity = events;
+    if (!g_events.isEmpty()) {
+        g_events.resize(g_capacity);
+    }
+    clear();
+}
+
+int Trace::capacity()
+{
+    return g_capacity;
+}
+
+qint64 Trace::recordedCount()
+{
+    return g_recorded.load(std::memory_order_relaxed);
+}
+
+void Trace::clear()
+{
+    g_recorded.store(0, std::memory_order_relaxed);
+}
+
+qint64 Trace::now()
+{
+    return g_clock.isValid() ? g_clock.nsecsElapsed() : 0;
+}
+
+void Trace::record(const char *name, const char *category, qint64 startNs, qint64 durationNs)
+{
+    if (g_events.isEmpty()) {
+        return;
+    }
+
+    qint64 slot = g_recorded.fetch_add(1, std::memory_order_relaxed) % g_events.size();
+    Event &event = g_events[int(slot)];
+    event.name = name;
+    event.category = category;
+    event.start = startNs;
+    event.duration = durationNs;
+    event.thread = quintptr(QThread::currentThreadId());
+}
+
+QByteArray Trace::toChromeTrace()
+{
+    QJsonArray traceEvents;
+
+    qint64 recorded = recordedCount();
+    int count = int(qMin<qint64>(recorded, g_events.size()));
+    int first = recorded > g_events.size() ? int(recorded % g_events.size()) : 0;
+
+    // Small thread ids in order of appearance, the viewer sorts by them
+    QHash<quintptr, int> threadIds;
+
+    for (int i = 0; i < count; ++i) {
+        const Event &event = g_events.at((first + i) % g_events.size());
+
+        int tid = threadIds.value(event.thread, -1);
+        if (tid < 0) {
+            tid = threadIds.size() + 1;
+            threadIds.insert(event.thread, tid);
+        }
+
+        // Complete events, times in microseconds
+        QJsonObject object;
+        object.insert(QStringLiteral("name"), QLatin1String(event.name));
+        object.insert(QStringLiteral("cat"), QLatin1String(event.category));
+        object.insert(QStringLiteral("ph"), QStringLiteral("X"));
+        object.insert(QStringLiteral("ts"), event.start / 1000.0);
+        object.insert(QStringLiteral("dur"), event.duration / 1000.0);
+        object.insert(QStringLiteral("pid"), 1);
+        object.insert(QStringLiteral("tid"), tid);
+        traceEvents.append(object);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("traceEvents"), traceEvents);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ns"));
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Trace::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(toChromeTrace()) >= 0;
+}
@@ -0,0 +1,82 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <atomic>
+
+// Opt-in tracing of where time goes in the UI. Spans are recorded into a
+// preallocated ring buffer (the oldest events are overwritten) and written
+// out as Chrome trace JSON on demand, for chrome://tracing or Perfetto.
+//
+// While tracing is disabled a span costs one relaxed atomic load; build
+// with DEFINES += MENUWIDGET_NO_TRACE to compile the spans out entirely.
+class Trace
+{
+public:
+    // Start or stop recording; the buffer is allocated on first enable
+    static void setEnabled(bool enabled);
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Number of events kept, 65536 by default. Clears the buffer; call
+    // while tracing is disabled.
+    static void setCapacity(int events);
+    static int capacity();
+
+    // Events recorded since the last clear(), including overwritten ones
+    static qint64 recordedCount();
+    static void clear();
+
+    // Nanoseconds since tracing was first enabled
+    static qint64 now();
+
+    // Record a complete span. name and category must outlive the trace
+    // (string literals).
+    static void record(const char *name, const char *category, qint64 startNs, qint64 durationNs);
+
+    // The buffered events, oldest first, as a Chrome trace JSON document
+    static QByteArray toChromeTrace();
+    static bool writeChromeTrace(const QString &fileName);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Records the time from its construction to the end of the scope
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "ui")
+        : m_name(Trace::isEnabled() ? name : nullptr)
+        , m_category(category)
+        , m_start(m_name ? Trace::now() : 0)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (m_name) {
+            Trace::record(m_name, m_category, m_start, Trace::now() - m_start);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(TraceSpan)
+
+    const char *m_name;
+    const char *m_category;
+    qint64 m_start;
+};
+
+#ifdef MENUWIDGET_NO_TRACE
+#define TRACE_SPAN(name)
+#else
+#define TRACE_SPAN_CONCAT2(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT2(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_SPAN_CONCAT(traceSpan, __LINE__)(name)
+#endif
+
+#endif // TRACE_H
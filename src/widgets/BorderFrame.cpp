@@ -0,0 +1,66 @@
+#include "BorderFrame.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+BorderFrame::BorderFrame(QWidget *parent)
+    : QWidget(parent)
+    , m_borderColor(Qt::black)
+    , m_borderWidth(2)
+{
+    setContentsMargins(m_borderWidth, m_borderWidth, m_borderWidth, m_borderWidth);
+}
+
+BorderFrame::~BorderFrame()
+{
+}
+
+void BorderFrame::setBorderColor(const QColor &color)
+{
+    if (color == m_borderColor) {
+        return;
+    }
+
+    m_borderColor = color;
+    update();
+}
+
+QColor BorderFrame::borderColor() const
+{
+    return m_borderColor;
+}
+
+void BorderFrame::setBorderWidth(int width)
+{
+    if (width < 0 || width == m_borderWidth) {
+        return;
+    }
+
+    m_borderWidth = width;
+    setContentsMargins(width, width, width, width);
+    update();
+}
+
+int BorderFrame::borderWidth() const
+{
+    return m_borderWidth;
+}
+
+void BorderFrame::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    if (m_borderWidth == 0) {
+        return;
+    }
+
+    // Four bands along the edges, the inside is left to the children
+    QPainter painter(this);
+    const int w = width();
+    const int h = height();
+    const int b = m_borderWidth;
+    painter.fillRect(QRect(0, 0, w, b), m_borderColor);
+    painter.fillRect(QRect(0, h - b, w, b), m_borderColor);
+    painter.fillRect(QRect(0, b, b, h - 2 * b), m_borderColor);
+    painter.fillRect(QRect(w - b, b, b, h - 2 * b), m_borderColor);
+}
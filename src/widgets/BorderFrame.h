@@ -0,0 +1,36 @@
+#ifndef BORDERFRAME_H
+#define BORDERFRAME_H
+
+#include <QWidget>
+#include <QColor>
+
+// Widget with a solid colored border drawn in paintEvent(). Unlike a
+// "border: ..." stylesheet, the border does not cascade to the children
+// and changing its color only repaints the frame, nothing is re-polished.
+// The contents margins keep children clear of the border.
+class BorderFrame : public QWidget
+{
+    Q_OBJECT
+    Q_PROPERTY(QColor borderColor READ borderColor WRITE setBorderColor)
+    Q_PROPERTY(int borderWidth READ borderWidth WRITE setBorderWidth)
+
+public:
+    explicit BorderFrame(QWidget *parent = nullptr);
+    ~BorderFrame();
+
+    void setBorderColor(const QColor &color);
+    QColor borderColor() const;
+
+    // 2 pixels by default
+    void setBorderWidth(int width);
+    int borderWidth() const;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QColor m_borderColor;
+    int m_borderWidth;
+};
+
+#endif // BORDERFRAME_H
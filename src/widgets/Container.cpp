@@ -1,7 +1,9 @@
 #include "Container.h"
+#include "../trace/Trace.h"
 
 Container::Container(QWidget *parent)
     : QWidget(parent)
+    , m_currentWidget(nullptr)
 {
     m_layout = new QVBoxLayout(this);
     m_layout->setContentsMargins(0, 0, 0, 0);
@@ -10,59 +12,133 @@ Container::Container(QWidget *parent)
 
 Container::~Container()
 {
+    // Children are deleted after our members, so stop listening first
+    for (QWidget *widget : m_widgets) {
+        disconnect(widget, &QObject::destroyed, this, &Container::onWidgetDestroyed);
+    }
 }
 
 void Container::attach(QWidget *widget)
 {
-    if (!widget || m_widgets.contains(widget)) {
+    if (!widget || m_indices.contains(widget)) {
         return;
     }
 
-    // Add widget to layout and list
-    m_layout->addWidget(widget);
+    // Attached widgets are children but stay out of the layout until shown
+    if (widget->parentWidget() != this) {
+        widget->setParent(this);
+    }
+
+    m_indices.insert(widget, m_widgets.size());
     m_widgets.append(widget);
 
+    // Forget the widget if its owner deletes it while attached
+    connect(widget, &QObject::destroyed, this, &Container::onWidgetDestroyed);
+
     // Hide the widget by default
     widget->hide();
 }
 
 void Container::detach(QWidget *widget)
 {
-    if (!widget || !m_widgets.contains(widget)) {
+    if (!widget || !m_indices.contains(widget)) {
         return;
     }
 
-    // Remove from layout and list
-    m_layout->removeWidget(widget);
-    m_widgets.removeOne(widget);
+    take(widget);
 
     // The widget is not deleted, just removed from container
     widget->setParent(nullptr);
 }
 
+void Container::take(QWidget *widget)
+{
+    if (!widget || !m_indices.contains(widget)) {
+        return;
+    }
+
+    if (widget == m_currentWidget) {
+        m_layout->removeWidget(widget);
+    }
+
+    disconnect(widget, &QObject::destroyed, this, &Container::onWidgetDestroyed);
+    forget(widget);
+}
+
 void Container::show(QWidget *widget)
 {
-    if (!widget || !m_widgets.contains(widget)) {
+    TRACE_SPAN("Container::show");
+
+    if (!widget || !m_indices.contains(widget)) {
         return;
     }
 
-    // Hide all widgets first
+    if (widget == m_currentWidget) {
+        widget->show();
+        return;
+    }
+
+    // Only the previously shown widget needs hiding
     hideAll();
 
+    m_layout->addWidget(widget);
+    m_currentWidget = widget;
+
     // Show the specified widget
     widget->show();
 }
 
 void Container::hideAll()
 {
-    for (QWidget *widget : m_widgets) {
-        if (widget) {
-            widget->hide();
-        }
+    if (!m_currentWidget) {
+        return;
     }
+
+    m_currentWidget->hide();
+    m_layout->removeWidget(m_currentWidget);
+    m_currentWidget = nullptr;
+}
+
+bool Container::contains(QWidget *widget) const
+{
+    return m_indices.contains(widget);
+}
+
+QWidget *Container::currentWidget() const
+{
+    return m_currentWidget;
+}
+
+const QList<QWidget*> &Container::widgets() const
+{
+    return m_widgets;
 }
 
 QList<QWidget*> Container::getWidgets() const
 {
     return m_widgets;
 }
+
+void Container::forget(QWidget *widget)
+{
+    // Move the last widget into the hole, so removal does not shift the list
+    int index = m_indices.take(widget);
+    QWidget *last = m_widgets.takeLast();
+    if (last != widget) {
+        m_widgets[index] = last;
+        m_indices.insert(last, index);
+    }
+
+    if (widget == m_currentWidget) {
+        m_currentWidget = nullptr;
+    }
+}
+
+void Container::onWidgetDestroyed(QObject *object)
+{
+    // The layout removes the item itself when the child goes away
+    QWidget *widget = static_cast<QWidget*>(object);
+    if (m_indices.contains(widget)) {
+        forget(widget);
+    }
+}
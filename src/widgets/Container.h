@@ -3,8 +3,13 @@
 
 #include <QWidget>
 #include <QList>
+#include <QHash>
 #include <QVBoxLayout>
 
+// Holds any number of attached widgets and shows at most one of them, like
+// a QStackedLayout. Only the shown widget is in the layout; membership is
+// a hash lookup, so attach, detach and show do not depend on how many
+// widgets are attached.
 class Container : public QWidget
 {
     Q_OBJECT
@@ -19,18 +24,41 @@ public:
     // Detach a widget from the container
     void detach(QWidget *widget);
 
+    // Remove a widget from the container but keep it parented here, for a
+    // caller that attaches it to another container right away
+    void take(QWidget *widget);
+
     // Show a specific widget (hide all others)
     void show(QWidget *widget);
 
     // Hide all widgets
     void hideAll();
 
-    // Get all attached widgets
+    // Whether the widget is attached
+    bool contains(QWidget *widget) const;
+
+    // The shown widget, nullptr if none
+    QWidget *currentWidget() const;
+
+    // Attached widgets; the order changes when widgets are detached
+    const QList<QWidget*> &widgets() const;
+
+    // Get all attached widgets (a copy, prefer widgets())
     QList<QWidget*> getWidgets() const;
 
+private slots:
+    void onWidgetDestroyed(QObject *object);
+
 private:
+    void forget(QWidget *widget);
+
     QVBoxLayout *m_layout;
     QList<QWidget*> m_widgets;
+
+    // Position of each attached widget in m_widgets
+    QHash<QWidget*, int> m_indices;
+
+    QWidget *m_currentWidget;
 };
 
 #endif // CONTAINER_H
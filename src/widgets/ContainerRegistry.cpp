@@ -0,0 +1,72 @@
+#include "ContainerRegistry.h"
+#include "Container.h"
+
+ContainerRegistry::ContainerRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ContainerRegistry::~ContainerRegistry()
+{
+}
+
+Container *ContainerRegistry::container(QWidget *widget) const
+{
+    return m_containers.value(widget, nullptr);
+}
+
+void ContainerRegistry::moveTo(QWidget *widget, Container *target)
+{
+    if (!widget || !target) {
+        return;
+    }
+
+    Container *current = m_containers.value(widget, nullptr);
+    if (current == target) {
+        return;
+    }
+
+    if (current) {
+        current->take(widget);
+    } else {
+        // Forget the widget if its owner deletes it
+        connect(widget, &QObject::destroyed, this, &ContainerRegistry::onWidgetDestroyed);
+    }
+
+    // attach() reparents the widget straight into the target, hidden;
+    // the target's layout only takes it once it is shown there
+    target->attach(widget);
+    m_containers.insert(widget, target);
+}
+
+void ContainerRegistry::release(QWidget *widget)
+{
+    Container *current = m_containers.take(widget);
+    if (!current) {
+        return;
+    }
+
+    disconnect(widget, &QObject::destroyed, this, &ContainerRegistry::onWidgetDestroyed);
+    current->detach(widget);
+}
+
+void ContainerRegistry::releaseAll(Container *container)
+{
+    if (!container) {
+        return;
+    }
+
+    // Releasing reorders the container's list, iterate over a copy
+    const QList<QWidget*> widgets = container->widgets();
+    for (QWidget *widget : widgets) {
+        if (m_containers.value(widget, nullptr) == container) {
+            release(widget);
+        }
+    }
+}
+
+void ContainerRegistry::onWidgetDestroyed(QObject *object)
+{
+    // Containers drop the widget themselves
+    m_containers.remove(static_cast<QWidget*>(object));
+}
@@ -0,0 +1,42 @@
+#ifndef CONTAINERREGISTRY_H
+#define CONTAINERREGISTRY_H
+
+#include <QObject>
+#include <QHash>
+
+class QWidget;
+class Container;
+
+// Records which Container each registered widget is attached to, so the
+// holder of a widget is found with one lookup, and moves widgets from
+// one container to another directly: the widget is reparented once,
+// container to container, instead of going through a parentless
+// top-level state with detach() and attach().
+class ContainerRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ContainerRegistry(QObject *parent = nullptr);
+    ~ContainerRegistry();
+
+    // Container the widget is attached to, nullptr if none
+    Container *container(QWidget *widget) const;
+
+    // Attach the widget to target, taking it from its current container
+    void moveTo(QWidget *widget, Container *target);
+
+    // Detach the widget from its container and forget it
+    void release(QWidget *widget);
+
+    // Release every registered widget of a container, e.g. before deleting it
+    void releaseAll(Container *container);
+
+private slots:
+    void onWidgetDestroyed(QObject *object);
+
+private:
+    QHash<QWidget*, Container*> m_containers;
+};
+
+#endif // CONTAINERREGISTRY_H
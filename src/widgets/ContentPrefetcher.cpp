@@ -0,0 +1,246 @@
+#include "ContentPrefetcher.h"
+#include "MenuWidget.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLayout>
+#include <QTimer>
+
+namespace {
+
+// Quiet time after a selection or input before warming up starts
+const int IdleDelayMs = 150;
+
+// Work done per event loop pass; a single widget may take longer
+const int SliceBudgetMs = 4;
+
+// Selections remembered for prediction
+const int MaxHistory = 8;
+
+}
+
+ContentPrefetcher::ContentPrefetcher(QObject *parent)
+    : QObject(parent)
+    , m_enabled(false)
+    , m_depth(2)
+    , m_next(0)
+    , m_prefetchedCount(0)
+{
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(IdleDelayMs);
+    connect(m_idleTimer, &QTimer::timeout, this, &ContentPrefetcher::startWarmUp);
+
+    m_sliceTimer = new QTimer(this);
+    m_sliceTimer->setInterval(0);
+    connect(m_sliceTimer, &QTimer::timeout, this, &ContentPrefetcher::warmUpSlice);
+}
+
+ContentPrefetcher::~ContentPrefetcher()
+{
+    if (m_enabled && QCoreApplication::instance()) {
+        QCoreApplication::instance()->removeEventFilter(this);
+    }
+}
+
+void ContentPrefetcher::setMenuWidget(MenuWidget *menuWidget)
+{
+    if (menuWidget == m_menuWidget) {
+        return;
+    }
+
+    if (m_menuWidget) {
+        disconnect(m_menuWidget, nullptr, this, nullptr);
+    }
+
+    m_menuWidget = menuWidget;
+    m_history.clear();
+    m_queue.clear();
+    m_sliceTimer->stop();
+
+    if (m_menuWidget) {
+        connect(m_menuWidget.data(), &MenuWidget::tabSelectionChanged,
+                this, &ContentPrefetcher::onTabSelectionChanged);
+        connect(m_menuWidget.data(), &MenuWidget::tabsRearranged,
+                this, &ContentPrefetcher::onTabsRearranged);
+    }
+}
+
+void ContentPrefetcher::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled || !QCoreApplication::instance()) {
+        return;
+    }
+
+    m_enabled = enabled;
+
+    // Input anywhere in the application interrupts the warm-up
+    if (m_enabled) {
+        QCoreApplication::instance()->installEventFilter(this);
+        m_idleTimer->start();
+    } else {
+        QCoreApplication::instance()->removeEventFilter(this);
+        m_idleTimer->stop();
+        m_sliceTimer->stop();
+    }
+}
+
+bool ContentPrefetcher::isEnabled() const
+{
+    return m_enabled;
+}
+
+void ContentPrefetcher::setHints(const QVector<Position> &hints)
+{
+    m_hints = hints;
+}
+
+void ContentPrefetcher::setDepth(int depth)
+{
+    m_depth = qMax(0, depth);
+}
+
+int ContentPrefetcher::prefetchedCount() const
+{
+    return m_prefetchedCount;
+}
+
+bool ContentPrefetcher::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::Wheel:
+    case QEvent::TouchBegin:
+        pause();
+        break;
+    default:
+        break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+void ContentPrefetcher::pause()
+{
+    // Predictions are made again from the selection the input leads to
+    m_sliceTimer->stop();
+    m_idleTimer->start();
+}
+
+void ContentPrefetcher::onTabSelectionChanged(int level1Index, int level2Index)
+{
+    Position position(level1Index, level2Index);
+    if (m_history.isEmpty() || m_history.last() != position) {
+        m_history.removeOne(position);
+        m_history.append(position);
+        if (m_history.size() > MaxHistory) {
+            m_history.removeFirst();
+        }
+    }
+
+    if (m_enabled) {
+        pause();
+    }
+}
+
+void ContentPrefetcher::onTabsRearranged()
+{
+    // Recorded positions may now point at other items
+    m_history.clear();
+    m_queue.clear();
+    m_sliceTimer->stop();
+}
+
+QVector<ContentPrefetcher::Position> ContentPrefetcher::predict() const
+{
+    QVector<Position> candidates;
+    if (m_history.isEmpty()) {
+        return candidates;
+    }
+
+    const Position current = m_history.last();
+    auto add = [&candidates, &current](const Position &position) {
+        if (position.first >= 0 && position.second >= 0 && position != current
+                && !candidates.contains(position)) {
+            candidates.append(position);
+        }
+    };
+
+    // Keep going the way the user moved within the category
+    int step = 1;
+    if (m_history.size() > 1) {
+        const Position &previous = m_history.at(m_history.size() - 2);
+        if (previous.first == current.first && previous.second > current.second) {
+            step = -1;
+        }
+    }
+
+    for (int distance = 1; distance <= m_depth; ++distance) {
+        add(Position(current.first, current.second + step * distance));
+        add(Position(current.first, current.second - step * distance));
+    }
+
+    for (const Position &hint : m_hints) {
+        add(hint);
+    }
+
+    // Going back is common too, most recent first
+    for (int i = m_history.size() - 2; i >= 0; --i) {
+        add(m_history.at(i));
+    }
+
+    return candidates;
+}
+
+void ContentPrefetcher::startWarmUp()
+{
+    if (!m_enabled || !m_menuWidget) {
+        return;
+    }
+
+    m_queue = predict();
+    m_next = 0;
+
+    if (!m_queue.isEmpty()) {
+        m_sliceTimer->start();
+    }
+}
+
+void ContentPrefetcher::warmUpSlice()
+{
+    if (!m_menuWidget) {
+        m_sliceTimer->stop();
+        return;
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+
+    while (m_next < m_queue.size() && budget.elapsed() < SliceBudgetMs) {
+        const Position &position = m_queue.at(m_next++);
+
+        // Invalid positions just return nothing
+        int builtBefore = m_menuWidget->builtContentCount();
+        CustomWidget *widget = m_menuWidget->getContentWidget(position.first, position.second);
+        if (!widget) {
+            continue;
+        }
+
+        if (m_menuWidget->builtContentCount() > builtBefore) {
+            ++m_prefetchedCount;
+        }
+
+        // What the first show would otherwise do on the click
+        widget->ensurePolished();
+        if (QLayout *layout = widget->layout()) {
+            layout->activate();
+        }
+    }
+
+    if (m_next >= m_queue.size()) {
+        m_sliceTimer->stop();
+        m_queue.clear();
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef CONTENTPREFETCHER_H
+#define CONTENTPREFETCHER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QList>
+#include <QPair>
+
+class QTimer;
+class MenuWidget;
+
+// Builds content widgets before they are first selected, while the user
+// is idle. After each selection it predicts the next likely ones: the
+// neighbouring level 2 tabs, in the direction of travel first, the hints
+// given by the owner (e.g. the items of the other areas) and recently
+// visited items. These are built, polished and laid out in short time
+// slices from the event loop; any key, mouse or wheel input stops the
+// warm-up until the user is idle again.
+class ContentPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // (level1, level2) position of a content widget
+    typedef QPair<int, int> Position;
+
+    explicit ContentPrefetcher(QObject *parent = nullptr);
+    ~ContentPrefetcher();
+
+    void setMenuWidget(MenuWidget *menuWidget);
+
+    // Off by default
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Positions likely to be shown soon besides the selection's neighbours
+    void setHints(const QVector<Position> &hints);
+
+    // Neighbouring tabs warmed up on each side of the selection
+    void setDepth(int depth);
+
+    // Content widgets built by the prefetcher
+    int prefetchedCount() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onTabSelectionChanged(int level1Index, int level2Index);
+    void onTabsRearranged();
+    void startWarmUp();
+    void warmUpSlice();
+
+private:
+    void pause();
+    QVector<Position> predict() const;
+
+    QPointer<MenuWidget> m_menuWidget;
+    bool m_enabled;
+    int m_depth;
+
+    // Recent selections, newest last
+    QList<Position> m_history;
+    QVector<Position> m_hints;
+
+    // Predicted positions and the next one to warm up
+    QVector<Position> m_queue;
+    int m_next;
+
+    // Waits for the user to be idle, then runs the slices
+    QTimer *m_idleTimer;
+    QTimer *m_sliceTimer;
+
+    int m_prefetchedCount;
+};
+
+#endif // CONTENTPREFETCHER_H
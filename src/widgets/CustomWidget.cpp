@@ -1,4 +1,7 @@
 #include "CustomWidget.h"
+#include "../trace/Trace.h"
+
+#include <QPaintEvent>
 
 CustomWidget::CustomWidget(const QString &text, QWidget *parent)
     : QWidget(parent)
@@ -24,3 +27,10 @@ QString CustomWidget::getText() const
 {
     return m_label->text();
 }
+
+void CustomWidget::paintEvent(QPaintEvent *event)
+{
+    // The label child paints in its own event, right after this one
+    TRACE_SPAN("CustomWidget::paint");
+    QWidget::paintEvent(event);
+}
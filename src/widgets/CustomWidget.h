@@ -16,6 +16,9 @@ public:
     void setText(const QString &text);
     QString getText() const;
 
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
 private:
     QLabel *m_label;
     QVBoxLayout *m_layout;
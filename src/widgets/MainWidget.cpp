@@ -2,40 +2,63 @@
 #include "ui_MainWidget.h"
 #include "MenuWidget.h"
 #include "Container.h"
+#include "ContainerRegistry.h"
 #include "CustomWidget.h"
+#include "MirrorWidget.h"
+#include "ContentPrefetcher.h"
+#include "BorderFrame.h"
+#include "../trace/Trace.h"
+#include <QEvent>
+#include <QDataStream>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QGridLayout>
+
+namespace {
+
+// Default border and active label color of each area
+const char *const DefaultAreaColors[] = { "red", "blue", "darkorange", "purple", "teal", "brown" };
+
+// Leading bytes of saveState() blobs
+const quint32 StateMagic = 0x4d4e4153;  // "MNAS"
+const quint8 StateVersion = 1;
+
+// Upper bound on the areas a restored state may ask for
+const int MaxAreas = 64;
+
+}
 
 MainWidget::MainWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::MainWidget)
     , m_menuWidget(nullptr)
+    , m_gridRows(0)
+    , m_gridColumns(0)
     , m_currentArea(0)
+    , m_mirrorMode(false)
 {
     ui->setupUi(this);
 
-    // Initialize area indices - Area 1 starts with Category 1 Item 1, Area 2 with Category 1 Item 2
-    m_areaLevel1Index[0] = 0;
-    m_areaLevel1Index[1] = 0;
-    m_areaLevel2Index[0] = 0;
-    m_areaLevel2Index[1] = 1;
-
-    // Create containers for each area
-    for (int i = 0; i < 2; ++i) {
-        m_areaContainers[i] = new Container(this);
+    for (const char *color : DefaultAreaColors) {
+        m_areaColors.append(QColor(color));
     }
 
-    // Setup containers in subWidget1 and subWidget2
-    QVBoxLayout *layout1 = new QVBoxLayout(ui->subWidget1);
-    layout1->setContentsMargins(0, 0, 0, 0);
-    layout1->addWidget(m_areaContainers[0]);
+    m_registry = new ContainerRegistry(this);
+    m_prefetcher = new ContentPrefetcher(this);
 
-    QVBoxLayout *layout2 = new QVBoxLayout(ui->subWidget2);
-    layout2->setContentsMargins(0, 0, 0, 0);
-    layout2->addWidget(m_areaContainers[1]);
+    // Areas are laid out in a grid inside areaGridContainer
+    m_areaLayout = new QGridLayout(ui->areaGridContainer);
+    m_areaLayout->setContentsMargins(0, 0, 0, 0);
 
-    // Setup area buttons and labels
-    setupAreaButtons();
+    // Area buttons and labels go in a row at the top
+    m_areaButtonLayout = new QHBoxLayout();
+    QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(layout());
+    if (mainLayout) {
+        mainLayout->insertLayout(0, m_areaButtonLayout);
+    }
+
+    // Two areas side by side
+    setAreaGrid(1, 2);
 }
 
 MainWidget::~MainWidget()
@@ -43,36 +66,107 @@ MainWidget::~MainWidget()
     delete ui;
 }
 
-void MainWidget::setupAreaButtons()
+void MainWidget::setAreaGrid(int rows, int columns)
 {
-    // Create buttons and labels
-    m_area1Button = new QPushButton("Area 1", this);
-    m_area2Button = new QPushButton("Area 2", this);
-    m_area1Label = new QLabel("Area 1: [ACTIVE]", this);
-    m_area2Label = new QLabel("Area 2:", this);
+    if (rows < 1 || columns < 1) {
+        return;
+    }
 
-    // Set initial button states
-    m_area1Button->setEnabled(false);
-    m_area1Label->setStyleSheet("font-weight: bold; color: red;");
+    // Areas that still exist keep showing what they showed
+    QVector<QPair<int, int> > positions;
+    for (const Area &area : m_areas) {
+        positions.append(qMakePair(area.level1Index, area.level2Index));
+    }
 
-    // Get the main layout and insert buttons at the top
-    QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(layout());
-    if (mainLayout) {
-        // Create button layout
-        QHBoxLayout *buttonLayout = new QHBoxLayout();
-        buttonLayout->addWidget(m_area1Label);
-        buttonLayout->addWidget(m_area1Button);
-        buttonLayout->addWidget(m_area2Label);
-        buttonLayout->addWidget(m_area2Button);
-        buttonLayout->addStretch();
+    buildAreas(rows, columns, positions);
+
+    if (m_currentArea >= m_areas.size()) {
+        m_currentArea = 0;
+        if (m_menuWidget) {
+            m_menuWidget->setCurrentTabs(m_areas.at(0).level1Index, m_areas.at(0).level2Index);
+        }
+    }
+    updateAreaStyles();
+    updatePrefetchHints();
 
-        // Insert at the top (index 0)
-        mainLayout->insertLayout(0, buttonLayout);
+    if (m_menuWidget) {
+        initializeAreas();
+    }
+}
+
+void MainWidget::buildAreas(int rows, int columns, const QVector<QPair<int, int> > &positions)
+{
+    clearAreas();
+
+    int count = rows * columns;
+    for (int i = 0; i < count; ++i) {
+        Area area;
+
+        area.frame = new BorderFrame(ui->areaGridContainer);
+        area.frame->setMinimumSize(300, 300);
+
+        area.container = new Container(area.frame);
+        area.mirror = nullptr;
+        area.itemId = 0;
+        QVBoxLayout *frameLayout = new QVBoxLayout(area.frame);
+        frameLayout->setContentsMargins(0, 0, 0, 0);
+        frameLayout->addWidget(area.container);
+
+        m_areaLayout->addWidget(area.frame, i / columns, i % columns);
+
+        area.label = new QLabel(this);
+        area.button = new QPushButton(QString("Area %1").arg(i + 1), this);
+        m_areaButtonLayout->addWidget(area.label);
+        m_areaButtonLayout->addWidget(area.button);
+
+        connect(area.button, &QPushButton::clicked, this, [this, i]() {
+            switchToArea(i);
+        });
+
+        // New areas start on item i of the first category
+        if (i < positions.size()) {
+            area.level1Index = positions.at(i).first;
+            area.level2Index = positions.at(i).second;
+        } else {
+            area.level1Index = 0;
+            area.level2Index = i;
+        }
+
+        m_areas.append(area);
     }
 
-    // Connect button signals
-    connect(m_area1Button, &QPushButton::clicked, this, &MainWidget::onArea1ButtonClicked);
-    connect(m_area2Button, &QPushButton::clicked, this, &MainWidget::onArea2ButtonClicked);
+    m_areaButtonLayout->addStretch();
+
+    m_gridRows = rows;
+    m_gridColumns = columns;
+}
+
+void MainWidget::clearAreas()
+{
+    for (const Area &area : m_areas) {
+        // Content widgets belong to the menu, take them out before the frame goes
+        m_registry->releaseAll(area.container);
+
+        delete area.frame;
+        delete area.label;
+        delete area.button;
+    }
+    m_areas.clear();
+
+    // Drop the trailing stretch
+    while (QLayoutItem *item = m_areaButtonLayout->takeAt(0)) {
+        delete item;
+    }
+}
+
+int MainWidget::areaCount() const
+{
+    return m_areas.size();
+}
+
+int MainWidget::currentArea() const
+{
+    return m_currentArea;
 }
 
 void MainWidget::setMenuWidget(MenuWidget *menuWidget)
@@ -103,104 +197,344 @@ void MainWidget::setMenuWidget(MenuWidget *menuWidget)
         // Connect signal from MenuWidget
         connect(m_menuWidget, &MenuWidget::tabSelectionChanged,
                 this, &MainWidget::onMenuTabSelectionChanged);
+        connect(m_menuWidget, &MenuWidget::tabsRearranged,
+                this, &MainWidget::onMenuTabsRearranged);
     }
+
+    m_prefetcher->setMenuWidget(m_menuWidget);
+    updatePrefetchHints();
 }
 
 void MainWidget::initializeAreas()
 {
-    // Initialize both areas with their default widgets
-    updateAreaDisplay(0);  // Area 1
-    updateAreaDisplay(1);  // Area 2
+    // Initialize all areas with their default widgets
+    for (int areaIndex = 0; areaIndex < m_areas.size(); ++areaIndex) {
+        updateAreaDisplay(areaIndex);
+    }
 }
 
-void MainWidget::onArea1ButtonClicked()
+void MainWidget::switchToArea(int areaIndex)
 {
-    switchToArea(0);
+    if (areaIndex < 0 || areaIndex >= m_areas.size() || m_currentArea == areaIndex) {
+        return;
+    }
+
+    // A selection the menu still holds back belongs to the area we leave
+    if (m_menuWidget) {
+        m_menuWidget->flushPendingSelection();
+    }
+
+    // Update current area
+    int previousArea = m_currentArea;
+    m_currentArea = areaIndex;
+
+    // Only the two areas whose state changed are restyled
+    updateAreaButton(previousArea);
+    updateAreaButton(areaIndex);
+    updatePrefetchHints();
+
+    // Update menu tabs to match the new area's indices
+    if (m_menuWidget) {
+        const Area &area = m_areas.at(areaIndex);
+        m_menuWidget->setCurrentTabs(area.level1Index, area.level2Index);
+    }
+
+    emit currentAreaChanged(areaIndex);
 }
 
-void MainWidget::onArea2ButtonClicked()
+void MainWidget::setMirrorMode(bool enabled)
 {
-    switchToArea(1);
+    if (m_mirrorMode == enabled) {
+        return;
+    }
+
+    m_mirrorMode = enabled;
+
+    // Blank areas start mirroring, mirroring areas go blank
+    initializeAreas();
 }
 
-void MainWidget::switchToArea(int areaIndex)
+bool MainWidget::mirrorMode() const
 {
-    if (areaIndex < 0 || areaIndex > 1 || m_currentArea == areaIndex) {
-        return;
+    return m_mirrorMode;
+}
+
+ContentPrefetcher *MainWidget::contentPrefetcher() const
+{
+    return m_prefetcher;
+}
+
+void MainWidget::setAreaColors(const QVector<QColor> &colors)
+{
+    m_areaColors = colors;
+    updateAreaStyles();
+}
+
+QVector<QColor> MainWidget::areaColors() const
+{
+    return m_areaColors;
+}
+
+void MainWidget::changeEvent(QEvent *event)
+{
+    // Palette or font of the theme changed, recompute the active styles
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange) {
+        updateAreaStyles();
     }
+    QWidget::changeEvent(event);
+}
 
-    // Update current area
-    m_currentArea = areaIndex;
+void MainWidget::updatePrefetchHints()
+{
+    // Switching to another area shows its item, warm those up too
+    QVector<QPair<int, int> > hints;
+    for (int areaIndex = 0; areaIndex < m_areas.size(); ++areaIndex) {
+        if (areaIndex != m_currentArea) {
+            hints.append(qMakePair(m_areas.at(areaIndex).level1Index, m_areas.at(areaIndex).level2Index));
+        }
+    }
+    m_prefetcher->setHints(hints);
+}
 
-    // Update button states
-    m_area1Button->setEnabled(areaIndex != 0);
-    m_area2Button->setEnabled(areaIndex != 1);
+QByteArray MainWidget::saveState() const
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << StateMagic << StateVersion
+           << qint32(m_gridRows) << qint32(m_gridColumns)
+           << qint32(m_currentArea) << m_mirrorMode;
+    for (const Area &area : m_areas) {
+        stream << qint32(area.level1Index) << qint32(area.level2Index);
+    }
+    stream << (m_menuWidget ? m_menuWidget->saveState() : QByteArray());
 
-    // Update labels
-    if (areaIndex == 0) {
-        m_area1Label->setText("Area 1: [ACTIVE]");
-        m_area1Label->setStyleSheet("font-weight: bold; color: red;");
-        m_area2Label->setText("Area 2:");
-        m_area2Label->setStyleSheet("");
+    return state;
+}
+
+bool MainWidget::restoreState(const QByteArray &state)
+{
+    QDataStream stream(state);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint8 version = 0;
+    qint32 rows = 0;
+    qint32 columns = 0;
+    qint32 currentArea = 0;
+    bool mirrorMode = false;
+    stream >> magic >> version >> rows >> columns >> currentArea >> mirrorMode;
+    if (stream.status() != QDataStream::Ok || magic != StateMagic || version != StateVersion
+            || rows < 1 || columns < 1 || rows > MaxAreas || columns > MaxAreas / rows) {
+        return false;
+    }
+
+    // Read everything before changing anything
+    QVector<QPair<int, int> > positions;
+    for (int i = 0; i < rows * columns; ++i) {
+        qint32 level1Index, level2Index;
+        stream >> level1Index >> level2Index;
+        positions.append(qMakePair(int(level1Index), int(level2Index)));
+    }
+    QByteArray menuState;
+    stream >> menuState;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    if (rows != m_gridRows || columns != m_gridColumns) {
+        buildAreas(rows, columns, positions);
     } else {
-        m_area1Label->setText("Area 1:");
-        m_area1Label->setStyleSheet("");
-        m_area2Label->setText("Area 2: [ACTIVE]");
-        m_area2Label->setStyleSheet("font-weight: bold; color: blue;");
+        for (int i = 0; i < m_areas.size(); ++i) {
+            m_areas[i].level1Index = positions.at(i).first;
+            m_areas[i].level2Index = positions.at(i).second;
+        }
     }
+    m_currentArea = qBound(0, int(currentArea), m_areas.size() - 1);
+    m_mirrorMode = mirrorMode;
 
-    // Update menu tabs to match the new area's indices
     if (m_menuWidget) {
-        int level1Index = m_areaLevel1Index[areaIndex];
-        int level2Index = m_areaLevel2Index[areaIndex];
-        m_menuWidget->setCurrentTabs(level1Index, level2Index);
+        if (!menuState.isEmpty()) {
+            m_menuWidget->restoreState(menuState);
+        }
+
+        // The menu shows the current area's item, without a selection signal
+        const Area &area = m_areas.at(m_currentArea);
+        m_menuWidget->setCurrentTabs(area.level1Index, area.level2Index);
+    }
+
+    updateAreaStyles();
+    updatePrefetchHints();
+
+    // Only the items the areas show are built
+    if (m_menuWidget) {
+        initializeAreas();
+    }
+
+    // As switchToArea() does, so listeners follow the restored area
+    emit currentAreaChanged(m_currentArea);
+    return true;
+}
+
+QColor MainWidget::areaColor(int areaIndex) const
+{
+    if (m_areaColors.isEmpty()) {
+        return palette().color(QPalette::WindowText);
+    }
+    return m_areaColors.at(areaIndex % m_areaColors.size());
+}
+
+void MainWidget::updateAreaStyles()
+{
+    // Derived from the current palette and font so theme changes carry over
+    m_activeLabelFont = font();
+    m_activeLabelFont.setBold(true);
+
+    for (int areaIndex = 0; areaIndex < m_areas.size(); ++areaIndex) {
+        Area &area = m_areas[areaIndex];
+        QColor color = areaColor(areaIndex);
+
+        area.activeLabelPalette = palette();
+        area.activeLabelPalette.setColor(QPalette::WindowText, color);
+        area.frame->setBorderColor(color);
+    }
+
+    updateAreaButtons();
+}
+
+void MainWidget::updateAreaButtons()
+{
+    for (int areaIndex = 0; areaIndex < m_areas.size(); ++areaIndex) {
+        updateAreaButton(areaIndex);
+    }
+}
+
+void MainWidget::updateAreaButton(int areaIndex)
+{
+    if (areaIndex < 0 || areaIndex >= m_areas.size()) {
+        return;
+    }
+
+    const Area &area = m_areas.at(areaIndex);
+    bool active = areaIndex == m_currentArea;
+
+    area.button->setEnabled(!active);
+
+    if (active) {
+        area.label->setText(QString("Area %1: [ACTIVE]").arg(areaIndex + 1));
+        area.label->setPalette(area.activeLabelPalette);
+        area.label->setFont(m_activeLabelFont);
+    } else {
+        // Default-constructed values make the label inherit again
+        area.label->setText(QString("Area %1:").arg(areaIndex + 1));
+        area.label->setPalette(QPalette());
+        area.label->setFont(QFont());
     }
 }
 
 void MainWidget::onMenuTabSelectionChanged(int level1Index, int level2Index)
 {
+    TRACE_SPAN("MainWidget::onMenuTabSelectionChanged");
+
+    if (m_currentArea >= m_areas.size()) {
+        return;
+    }
+
     // Save the indices for the current area
-    m_areaLevel1Index[m_currentArea] = level1Index;
-    m_areaLevel2Index[m_currentArea] = level2Index;
+    m_areas[m_currentArea].level1Index = level1Index;
+    m_areas[m_currentArea].level2Index = level2Index;
 
     // Update display for the current area
     updateAreaDisplay(m_currentArea);
+    updatePrefetchHints();
+}
+
+void MainWidget::onMenuTabsRearranged()
+{
+    QAbstractItemModel *model = m_menuWidget ? m_menuWidget->model() : nullptr;
+    if (!model) {
+        return;
+    }
+
+    // Areas follow their item to its new indices; an area whose item was
+    // removed shows the item that took its place, as the menu's strip does
+    for (int areaIndex = 0; areaIndex < m_areas.size(); ++areaIndex) {
+        Area &area = m_areas[areaIndex];
+        if (!area.itemId) {
+            continue;
+        }
+
+        int level1Index, level2Index;
+        if (m_menuWidget->findTab(area.itemId, &level1Index, &level2Index)) {
+            area.level1Index = level1Index;
+            area.level2Index = level2Index;
+            continue;
+        }
+
+        area.level1Index = qMax(0, qMin(area.level1Index, model->rowCount() - 1));
+        int itemCount = model->rowCount(model->index(area.level1Index, 0));
+        area.level2Index = qMax(0, qMin(area.level2Index, itemCount - 1));
+        updateAreaDisplay(areaIndex);
+    }
+
+    updatePrefetchHints();
 }
 
 void MainWidget::updateAreaDisplay(int areaIndex)
 {
-    if (!m_menuWidget) {
+    TRACE_SPAN("MainWidget::updateAreaDisplay");
+
+    if (!m_menuWidget || areaIndex < 0 || areaIndex >= m_areas.size()) {
         return;
     }
 
-    int level1Index = m_areaLevel1Index[areaIndex];
-    int level2Index = m_areaLevel2Index[areaIndex];
+    Area &area = m_areas[areaIndex];
+    QWidget *previousWidget = area.container->currentWidget();
+
+    // Lets the area find its item again once tabs are removed or moved
+    area.itemId = m_menuWidget->level2TabId(area.level1Index, area.level2Index);
 
     // Get the content widget for this area's indices
-    CustomWidget *contentWidget = m_menuWidget->getContentWidget(level1Index, level2Index);
+    CustomWidget *contentWidget = m_menuWidget->getContentWidget(area.level1Index, area.level2Index);
     if (!contentWidget) {
-        m_areaContainers[areaIndex]->hideAll();
-        return;
+        area.container->hideAll();
+    } else {
+        // Check if this widget is being displayed in another area
+        Container *owner = m_registry->container(contentWidget);
+        if (owner && owner != area.container && contentWidget->isVisible()) {
+            if (m_mirrorMode) {
+                // Show a rendering of it, refreshed when it repaints
+                if (!area.mirror) {
+                    area.mirror = new MirrorWidget(area.container);
+                    area.container->attach(area.mirror);
+                }
+                area.mirror->setSource(contentWidget);
+                area.container->show(area.mirror);
+            } else {
+                // Widget is being used by another area, don't take it - hide all widgets in this area
+                area.container->hideAll();
+            }
+        } else {
+            // Move it here, straight from the container it was attached to
+            m_registry->moveTo(contentWidget, area.container);
+            area.container->show(contentWidget);
+        }
     }
 
-    // Check if this widget is being displayed in the other area
-    int otherArea = (areaIndex == 0) ? 1 : 0;
-    bool isUsedByOtherArea = m_areaContainers[otherArea]->getWidgets().contains(contentWidget)
-                             && contentWidget->isVisible();
+    // An idle mirror must not keep watching its source
+    if (area.mirror && area.container->currentWidget() != area.mirror) {
+        area.mirror->setSource(nullptr);
+    }
 
-    if (isUsedByOtherArea) {
-        // Widget is being used by other area, don't take it - hide all widgets in this area
-        m_areaContainers[areaIndex]->hideAll();
-    } else {
-        // Widget is not being used by other area, we can use it
-        // Detach from other area if needed (in case it was attached but hidden)
-        m_areaContainers[otherArea]->detach(contentWidget);
-
-        // Set parent and attach to this area
-        contentWidget->setParent(m_areaContainers[areaIndex]);
-        if (!m_areaContainers[areaIndex]->getWidgets().contains(contentWidget)) {
-            m_areaContainers[areaIndex]->attach(contentWidget);
+    // Areas mirroring the widget this area just gave up can show it for real
+    if (previousWidget && previousWidget != area.mirror
+            && previousWidget != area.container->currentWidget()) {
+        for (int otherArea = 0; otherArea < m_areas.size(); ++otherArea) {
+            MirrorWidget *mirror = m_areas.at(otherArea).mirror;
+            if (otherArea != areaIndex && mirror && mirror->source() == previousWidget) {
+                updateAreaDisplay(otherArea);
+            }
         }
-        m_areaContainers[areaIndex]->show(contentWidget);
     }
 }
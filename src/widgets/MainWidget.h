@@ -4,7 +4,10 @@
 #include <QWidget>
 #include <QPushButton>
 #include <QLabel>
-#include <QMap>
+#include <QVector>
+#include <QColor>
+#include <QPalette>
+#include <QFont>
 
 namespace Ui {
 class MainWidget;
@@ -12,7 +15,13 @@ class MainWidget;
 
 class MenuWidget;
 class Container;
+class ContainerRegistry;
 class CustomWidget;
+class MirrorWidget;
+class BorderFrame;
+class ContentPrefetcher;
+class QGridLayout;
+class QHBoxLayout;
 
 class MainWidget : public QWidget
 {
@@ -25,34 +34,97 @@ public:
     // Set the MenuWidget to be displayed in the menu container
     void setMenuWidget(MenuWidget *menuWidget);
 
-    // Initialize both areas with their default widgets
+    // Initialize all areas with their default widgets
     void initializeAreas();
 
+    // Lay the areas out as a rows x columns grid (1 x 2 by default).
+    // Area i starts on item i of the first category.
+    void setAreaGrid(int rows, int columns);
+    int areaCount() const;
+
+    // Area that follows the menu selection
+    int currentArea() const;
+    void switchToArea(int areaIndex);
+
+    // When an area selects an item already shown in another area, show a
+    // cached rendering of it instead of leaving the area blank
+    void setMirrorMode(bool enabled);
+    bool mirrorMode() const;
+
+    // Warms up content widgets likely to be selected next while the user
+    // is idle (disabled until setEnabled(true)); the items of the other
+    // areas are among its predictions
+    ContentPrefetcher *contentPrefetcher() const;
+
+    // Area grid, the item each area shows, the current area, mirror mode
+    // and the menu's state (see MenuWidget::saveState()), as a compact
+    // binary blob. Restore before the widget is first shown and with the
+    // catalog in place: only the items the areas show are built, so the
+    // saved layout appears in the first frame.
+    QByteArray saveState() const;
+    bool restoreState(const QByteArray &state);
+
+    // Border and active label color of each area, repeated for large
+    // grids. Recolors every area in one pass.
+    void setAreaColors(const QVector<QColor> &colors);
+    QVector<QColor> areaColors() const;
+
+signals:
+    // Emitted by switchToArea() once the menu shows the area's item
+    void currentAreaChanged(int areaIndex);
+
+protected:
+    void changeEvent(QEvent *event) override;
+
 private slots:
-    void onArea1ButtonClicked();
-    void onArea2ButtonClicked();
     void onMenuTabSelectionChanged(int level1Index, int level2Index);
+    void onMenuTabsRearranged();
 
 private:
-    void setupAreaButtons();
-    void switchToArea(int areaIndex);
+    // One cell of the grid and the menu position it shows
+    struct Area {
+        BorderFrame *frame;
+        Container *container;
+        QPushButton *button;
+        QLabel *label;
+        QPalette activeLabelPalette;
+        MirrorWidget *mirror;   // Created on first use
+        int level1Index;
+        int level2Index;
+        quintptr itemId;        // MenuWidget::TabId of the item last shown
+    };
+
+    void buildAreas(int rows, int columns, const QVector<QPair<int, int> > &positions);
+    void clearAreas();
+    QColor areaColor(int areaIndex) const;
+    void updateAreaStyles();
+    void updateAreaButtons();
+    void updateAreaButton(int areaIndex);
     void updateAreaDisplay(int areaIndex);
+    void updatePrefetchHints();
 
     Ui::MainWidget *ui;
     MenuWidget *m_menuWidget;
 
-    // Area management
-    QPushButton *m_area1Button;
-    QPushButton *m_area2Button;
-    QLabel *m_area1Label;
-    QLabel *m_area2Label;
+    QGridLayout *m_areaLayout;
+    QHBoxLayout *m_areaButtonLayout;
 
-    Container *m_areaContainers[2];  // Containers for subWidget1 and subWidget2
+    QVector<Area> m_areas;
+    int m_gridRows;
+    int m_gridColumns;
     int m_currentArea;
+    bool m_mirrorMode;
+
+    // Active label styling, computed once per theme instead of set as a
+    // stylesheet (which re-polishes the label) on every switch
+    QVector<QColor> m_areaColors;
+    QFont m_activeLabelFont;
+
+    // Container each content widget is attached to; moves widgets
+    // between areas without a parentless hop
+    ContainerRegistry *m_registry;
 
-    // Remember indices for each area
-    int m_areaLevel1Index[2];
-    int m_areaLevel2Index[2];
+    ContentPrefetcher *m_prefetcher;
 };
 
 #endif // MAINWIDGET_H
@@ -1,140 +1,1336 @@
 #include "MenuWidget.h"
+#include "../model/SearchIndex.h"
+#include "../trace/Trace.h"
+
+#include <QDataStream>
+
+namespace {
+
+// Leading bytes of saveState() blobs
+const quint32 StateMagic = 0x4d4e5753;  // "MNWS"
+const quint8 StateVersion = 1;
+
+// Position of a row once count rows starting at first were moved to to
+int movedRow(int row, int first, int count, int to)
+{
+    if (row < 0) {
+        return row;
+    }
+    if (row >= first && row < first + count) {
+        return to + row - first;
+    }
+
+    int rest = row < first ? row : row - count;
+    return rest < to ? rest : rest + count;
+}
+
+// Delete a widget that may still be attached to an area's container
+void deleteFromContainer(QWidget *widget)
+{
+    if (Container *container = qobject_cast<Container*>(widget->parentWidget())) {
+        container->detach(widget);
+    }
+    delete widget;
+}
+
+}
 
 MenuWidget::MenuWidget(QWidget *parent)
     : QWidget(parent)
+    , m_shownCategory(-1)
+    , m_searchIndex(nullptr)
+    , m_pendingWidget(nullptr)
+    , m_updateDepth(0)
+    , m_selectionPending(false)
+    , m_builtContentBytes(0)
+    , m_maxContentWidgets(0)
+    , m_maxContentBytes(0)
+    , m_recyclingPoolSize(0)
+    , m_pendingLevel1Index(-1)
+    , m_pendingLevel2Index(-1)
+    , m_skippedSelections(0)
 {
     m_mainLayout = new QVBoxLayout(this);
 
     // Create level 1 tab bar
     m_level1TabBar = new QTabBar(this);
+    m_level1TabBar->setObjectName(QStringLiteral("level1TabBar"));
 
-    // Create container for level 2 tab bars
+    // Create container for the level 2 tab strip
     m_level2Container = new Container(this);
 
+    // A single level 2 strip is shared by all categories
+    m_level2TabStrip = new TabStrip(this);
+    m_level2TabStrip->setObjectName(QStringLiteral("level2TabStrip"));
+    m_level2Container->attach(m_level2TabStrip);
+    m_level2Container->show(m_level2TabStrip);
+
     // Add widgets to layout
     m_mainLayout->addWidget(m_level1TabBar);
     m_mainLayout->addWidget(m_level2Container);
 
     setLayout(m_mainLayout);
 
-    // Connect level 1 tab change signal
+    // Connect tab change signals
     connect(m_level1TabBar, &QTabBar::currentChanged,
             this, &MenuWidget::onLevel1TabChanged);
+    connect(m_level2TabStrip, &TabStrip::currentChanged,
+            this, &MenuWidget::onLevel2TabChanged);
+
+    // Eviction runs from the event loop, after the areas have been updated
+    m_trimTimer = new QTimer(this);
+    m_trimTimer->setSingleShot(true);
+    m_trimTimer->setInterval(0);
+    connect(m_trimTimer, &QTimer::timeout, this, &MenuWidget::trimContentWidgets);
+
+    // Restarted by every selection while coalescing, fires once input settles
+    m_selectionTimer = new QTimer(this);
+    m_selectionTimer->setSingleShot(true);
+    m_selectionTimer->setInterval(0);
+    connect(m_selectionTimer, &QTimer::timeout, this, &MenuWidget::emitPendingSelection);
+
+    // Start with a private catalog; setModel() can replace it with a shared one
+    setModel(new MenuModel(this));
 }
 
 MenuWidget::~MenuWidget()
 {
+    // A shared model outlives us, stop listening before members go away
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+
+    // Lazily built widgets no area has shown have no parent to delete
+    // them; the others may already be gone with their areas
+    for (const ContentEntry &entry : m_contentEntries) {
+        if (entry.lazy && entry.widget && !entry.widget->parent()) {
+            delete entry.widget.data();
+        }
+    }
+    releaseContentPools();
 }
 
-void MenuWidget::addLevel1Tab(const QString &tabName)
+void MenuWidget::setModel(QAbstractItemModel *model)
 {
-    // Get the index for the new level 1 tab
-    int level1Index = m_level1TabBar->count();
+    if (model == m_model) {
+        return;
+    }
+
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
 
-    // Create a new level 2 tab bar for this level 1 tab
-    QTabBar *level2TabBar = new QTabBar(this);
-    m_level2TabBars[level1Index] = level2TabBar;
+        // Drop the private catalog created by the constructor
+        if (m_model->parent() == this) {
+            m_model->deleteLater();
+        }
+    }
 
-    // Attach the level 2 tab bar to the container
-    m_level2Container->attach(level2TabBar);
+    m_model = model;
 
-    // Initialize the content widgets map for this level 2 tab bar
-    m_contentWidgets[level2TabBar] = QMap<int, CustomWidget*>();
+    if (m_model) {
+        // Growth, removal, moves and relabeling are applied incrementally
+        connect(m_model.data(), &QAbstractItemModel::rowsInserted,
+                this, &MenuWidget::onRowsInserted);
+        connect(m_model.data(), &QAbstractItemModel::rowsAboutToBeRemoved,
+                this, &MenuWidget::onRowsAboutToBeRemoved);
+        connect(m_model.data(), &QAbstractItemModel::rowsRemoved,
+                this, &MenuWidget::onRowsRemoved);
+        connect(m_model.data(), &QAbstractItemModel::rowsMoved,
+                this, &MenuWidget::onRowsMoved);
+        connect(m_model.data(), &QAbstractItemModel::dataChanged,
+                this, &MenuWidget::onDataChanged);
 
-    // Connect level 2 tab change signal
-    connect(level2TabBar, &QTabBar::currentChanged,
-            this, &MenuWidget::onLevel2TabChanged);
+        // Any other structural change rebuilds the tabs
+        connect(m_model.data(), &QAbstractItemModel::layoutChanged,
+                this, &MenuWidget::rebuildFromModel);
+        connect(m_model.data(), &QAbstractItemModel::modelReset,
+                this, &MenuWidget::rebuildFromModel);
+    }
 
-    // Add tab to level 1 tab bar
-    m_level1TabBar->addTab(tabName);
+    if (m_searchIndex) {
+        m_searchIndex->setModel(m_model);
+    }
+
+    rebuildFromModel();
+}
+
+QAbstractItemModel *MenuWidget::model() const
+{
+    return m_model;
+}
+
+MenuModel *MenuWidget::menuModel() const
+{
+    return qobject_cast<MenuModel*>(m_model.data());
+}
 
-    // If this is the first tab, show it
-    if (level1Index == 0) {
-        m_level1TabBar->setCurrentIndex(0);
-        m_level2Container->show(level2TabBar);
+void MenuWidget::addLevel1Tab(const QString &tabName)
+{
+    // The tab itself is created by onRowsInserted()
+    if (MenuModel *menu = menuModel()) {
+        menu->appendCategory(tabName);
     }
 }
 
 void MenuWidget::addLevel2Tab(int level1Index, const QString &tabName, CustomWidget *contentWidget)
 {
-    // Check if the level 1 index is valid
-    if (!m_level2TabBars.contains(level1Index)) {
+    MenuModel *menu = menuModel();
+    if (!menu) {
+        return;
+    }
+
+    // Picked up by insertItems() while the model notifies us
+    m_pendingWidget = contentWidget;
+    menu->appendItem(level1Index, tabName);
+    m_pendingWidget = nullptr;
+}
+
+void MenuWidget::addLevel2Tab(int level1Index, const QString &tabName, const ContentFactory &factory)
+{
+    if (MenuModel *menu = menuModel()) {
+        menu->appendItem(level1Index, tabName, factory);
+    }
+}
+
+void MenuWidget::addLevel2Tabs(int level1Index, const QStringList &tabNames,
+                               const QList<ContentFactory> &factories)
+{
+    MenuModel *menu = menuModel();
+    if (!menu) {
+        return;
+    }
+
+    // A single insertion grows the store and the strip in one step
+    beginUpdate();
+    menu->appendItems(level1Index, tabNames, factories);
+    endUpdate();
+}
+
+void MenuWidget::removeLevel1Tab(int level1Index)
+{
+    // The model notifies every view showing it, including this one
+    if (m_model && level1Index >= 0 && level1Index < m_categories.size()) {
+        m_model->removeRows(level1Index, 1);
+    }
+}
+
+void MenuWidget::removeLevel2Tab(int level1Index, int level2Index)
+{
+    if (!m_model || level1Index < 0 || level1Index >= m_categories.size()) {
+        return;
+    }
+
+    if (level2Index >= 0 && level2Index < m_categories.at(level1Index).itemCount) {
+        m_model->removeRows(level2Index, 1, m_model->index(level1Index, 0));
+    }
+}
+
+void MenuWidget::moveLevel1Tab(int from, int to)
+{
+    if (!m_model || from == to || from < 0 || from >= m_categories.size()
+            || to < 0 || to >= m_categories.size()) {
+        return;
+    }
+
+    // Rows are moved before destinationChild, counted before the move
+    m_model->moveRows(QModelIndex(), from, 1, QModelIndex(), to > from ? to + 1 : to);
+}
+
+void MenuWidget::moveLevel2Tab(int level1Index, int from, int to)
+{
+    if (!m_model || from == to || level1Index < 0 || level1Index >= m_categories.size()) {
+        return;
+    }
+
+    int itemCount = m_categories.at(level1Index).itemCount;
+    if (from < 0 || from >= itemCount || to < 0 || to >= itemCount) {
+        return;
+    }
+
+    QModelIndex parent = m_model->index(level1Index, 0);
+    m_model->moveRows(parent, from, 1, parent, to > from ? to + 1 : to);
+}
+
+MenuWidget::TabId MenuWidget::level1TabId(int level1Index) const
+{
+    if (!m_model || level1Index < 0 || level1Index >= m_categories.size()) {
+        return 0;
+    }
+
+    return m_model->index(level1Index, 0).data(MenuModel::IdRole).value<TabId>();
+}
+
+MenuWidget::TabId MenuWidget::level2TabId(int level1Index, int level2Index) const
+{
+    if (!m_model || level1Index < 0 || level1Index >= m_categories.size()
+            || level2Index < 0 || level2Index >= m_categories.at(level1Index).itemCount) {
+        return 0;
+    }
+
+    QModelIndex itemIndex = m_model->index(level2Index, 0, m_model->index(level1Index, 0));
+    return itemIndex.data(MenuModel::IdRole).value<TabId>();
+}
+
+bool MenuWidget::findTab(TabId id, int *level1Index, int *level2Index) const
+{
+    // Only a MenuModel can look rows up by id
+    MenuModel *menu = menuModel();
+    if (!menu || id == 0) {
+        return false;
+    }
+
+    QModelIndex index = menu->indexForId(id);
+    if (!index.isValid()) {
+        return false;
+    }
+
+    QModelIndex parent = index.parent();
+    *level1Index = parent.isValid() ? parent.row() : index.row();
+    *level2Index = parent.isValid() ? index.row() : -1;
+    return true;
+}
+
+void MenuWidget::beginUpdate()
+{
+    if (m_updateDepth++ > 0) {
+        return;
+    }
+
+    // Nothing is painted until endUpdate()
+    setUpdatesEnabled(false);
+}
+
+void MenuWidget::endUpdate()
+{
+    if (m_updateDepth == 0 || --m_updateDepth > 0) {
+        return;
+    }
+
+    // Level 1 tabs were added silently; catch up with the current one
+    int shownCategory = m_level1TabBar->currentIndex();
+    if (shownCategory != m_shownCategory) {
+        showCategory(shownCategory);
+        if (shownCategory >= 0 && m_level2TabStrip->currentIndex() >= 0) {
+            m_selectionPending = true;
+        }
+    }
+
+    m_level1TabBar->updateGeometry();
+    setUpdatesEnabled(true);
+
+    // Report where the selection ended up, once
+    if (m_selectionPending) {
+        m_selectionPending = false;
+
+        int level1Index = m_level1TabBar->currentIndex();
+        int level2Index = m_level2TabStrip->currentIndex();
+        if (level1Index >= 0 && level2Index >= 0) {
+            dispatchSelection(level1Index, level2Index);
+        }
+    }
+}
+
+void MenuWidget::reportSelection(int level1Index, int level2Index)
+{
+    // Held back while updating, endUpdate() reports the final selection
+    if (m_updateDepth > 0) {
+        m_selectionPending = true;
+        return;
+    }
+
+    dispatchSelection(level1Index, level2Index);
+}
+
+void MenuWidget::dispatchSelection(int level1Index, int level2Index)
+{
+    if (m_selectionTimer->interval() <= 0) {
+        emit tabSelectionChanged(level1Index, level2Index);
+        return;
+    }
+
+    // A selection still waiting is superseded by this one
+    if (m_selectionTimer->isActive()) {
+        ++m_skippedSelections;
+    }
+
+    m_pendingLevel1Index = level1Index;
+    m_pendingLevel2Index = level2Index;
+    m_selectionTimer->start();
+}
+
+void MenuWidget::emitPendingSelection()
+{
+    m_selectionTimer->stop();
+    emit tabSelectionChanged(m_pendingLevel1Index, m_pendingLevel2Index);
+}
+
+void MenuWidget::setSelectionCoalescing(int msec)
+{
+    // Turning coalescing off must not lose a held back selection
+    if (msec <= 0) {
+        flushPendingSelection();
+    }
+
+    m_selectionTimer->setInterval(qMax(0, msec));
+}
+
+int MenuWidget::selectionCoalescing() const
+{
+    return m_selectionTimer->interval();
+}
+
+void MenuWidget::flushPendingSelection()
+{
+    if (m_selectionTimer->isActive()) {
+        emitPendingSelection();
+    }
+}
+
+int MenuWidget::skippedSelectionCount() const
+{
+    return m_skippedSelections;
+}
+
+void MenuWidget::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (!parent.isValid()) {
+        // Without ids, categories inserted before existing ones shift the
+        // key of every item after them
+        if (first != m_categories.size() && !hasStableIds()) {
+            rebuildFromModel();
+            return;
+        }
+
+        insertCategories(first, last);
+        return;
+    }
+
+    // Only categories and their direct children are displayed
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    int level1Index = parent.row();
+    if (level1Index < 0 || level1Index >= m_categories.size()) {
+        return;
+    }
+
+    // Same for items inserted before existing ones
+    if (first != m_categories.at(level1Index).itemCount && !hasStableIds()) {
+        rebuildFromModel();
+        return;
+    }
+
+    bool wasEmpty = m_categories.at(level1Index).itemCount == 0;
+    insertItems(level1Index, first, last);
+
+    // The shown category is reported by the strip, which is notified after
+    // us; hidden categories report their first item themselves
+    if (wasEmpty && level1Index != m_shownCategory) {
+        reportSelection(level1Index, 0);
+    }
+}
+
+void MenuWidget::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    // Models without ids are rebuilt once the rows are gone
+    if (!hasStableIds() || parent.parent().isValid()) {
+        return;
+    }
+
+    // Content is dropped while the removed rows can still be looked up;
+    // a category takes its items along
+    QVector<ContentKey> keys;
+    if (!parent.isValid()) {
+        for (int level1Index = first; level1Index <= last && level1Index < m_categories.size(); ++level1Index) {
+            for (int level2Index = 0; level2Index < m_categories.at(level1Index).itemCount; ++level2Index) {
+                keys.append(contentKey(level1Index, level2Index));
+            }
+        }
+    } else {
+        for (int level2Index = first; level2Index <= last; ++level2Index) {
+            keys.append(contentKey(parent.row(), level2Index));
+        }
+    }
+    dropContent(keys);
+}
+
+void MenuWidget::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (!hasStableIds()) {
+        rebuildFromModel();
+        return;
+    }
+
+    // Only categories and their direct children are displayed
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    int count = last - first + 1;
+
+    if (!parent.isValid()) {
+        if (first < 0 || last >= m_categories.size()) {
+            rebuildFromModel();
+            return;
+        }
+
+        m_categories.remove(first, count);
+
+        // The strip's root went away with the shown category
+        bool shownRemoved = m_shownCategory >= first && m_shownCategory <= last;
+        if (shownRemoved) {
+            m_shownCategory = -1;
+        } else if (m_shownCategory > last) {
+            m_shownCategory -= count;
+        }
+
+        // Removing tabs before the current one renumbers it, which the tab
+        // bar would report as a selection
+        int current = m_level1TabBar->currentIndex();
+        m_level1TabBar->blockSignals(true);
+        for (int i = last; i >= first; --i) {
+            m_level1TabBar->removeTab(i);
+        }
+        m_level1TabBar->blockSignals(false);
+
+        // A removed current tab is replaced by its neighbour, as a click would
+        if (current >= first && current <= last) {
+            int level1Index = m_level1TabBar->currentIndex();
+            if (level1Index >= 0) {
+                onLevel1TabChanged(level1Index);
+            } else {
+                showCategory(-1);
+            }
+        }
+    } else {
+        int level1Index = parent.row();
+        if (level1Index < 0 || level1Index >= m_categories.size()) {
+            rebuildFromModel();
+            return;
+        }
+
+        // The shown category's strip selects and reports the neighbour
+        // itself, after us; hidden categories just remember it
+        Category &category = m_categories[level1Index];
+        category.itemCount = qMax(0, category.itemCount - count);
+        if (category.currentItem > last) {
+            category.currentItem -= count;
+        } else if (category.currentItem >= first) {
+            category.currentItem = qMin(first, category.itemCount - 1);
+        }
+    }
+
+    updatePendingSelection();
+    emit tabsRearranged();
+}
+
+void MenuWidget::onRowsMoved(const QModelIndex &parent, int start, int end,
+                             const QModelIndex &destination, int row)
+{
+    // Rows moving to another parent change their level 1 index
+    if (!hasStableIds() || parent != destination) {
+        rebuildFromModel();
+        return;
+    }
+
+    if (parent.parent().isValid()) {
+        return;
+    }
+
+    // row counts the moved rows themselves
+    int count = end - start + 1;
+    int to = row > start ? row - count : row;
+
+    if (!parent.isValid()) {
+        if (start < 0 || end >= m_categories.size()) {
+            rebuildFromModel();
+            return;
+        }
+
+        QVector<Category> moved = m_categories.mid(start, count);
+        m_categories.remove(start, count);
+        for (int i = 0; i < count; ++i) {
+            m_categories.insert(to + i, moved.at(i));
+        }
+        m_shownCategory = movedRow(m_shownCategory, start, count, to);
+
+        // The tab bar keeps its current tab through moves
+        m_level1TabBar->blockSignals(true);
+        for (int i = 0; i < count; ++i) {
+            if (to > start) {
+                m_level1TabBar->moveTab(start, to + count - 1);
+            } else {
+                m_level1TabBar->moveTab(start + i, to + i);
+            }
+        }
+        m_level1TabBar->blockSignals(false);
+    } else {
+        int level1Index = parent.row();
+        if (level1Index < 0 || level1Index >= m_categories.size()) {
+            rebuildFromModel();
+            return;
+        }
+
+        // The shown category's strip follows its current tab itself
+        Category &category = m_categories[level1Index];
+        category.currentItem = movedRow(category.currentItem, start, count, to);
+    }
+
+    updatePendingSelection();
+    emit tabsRearranged();
+}
+
+void MenuWidget::dropContent(const QVector<ContentKey> &keys)
+{
+    for (ContentKey key : keys) {
+        m_savedStates.remove(key);
+
+        auto it = m_contentEntries.find(key);
+        if (it == m_contentEntries.end()) {
+            continue;
+        }
+
+        // Pre-built widgets belong to the caller; a recycled widget stays
+        // in its pool and is rebound on demand
+        if (it->lazy) {
+            m_builtContentBytes -= it->estimatedBytes;
+            delete it->widget.data();
+            m_contentLru.erase(it->lruPosition);
+        }
+        m_contentEntries.erase(it);
+    }
+}
+
+void MenuWidget::updatePendingSelection()
+{
+    // A held back selection follows the current tabs to their new indices
+    if (!m_selectionTimer->isActive()) {
+        return;
+    }
+
+    int level1Index = m_level1TabBar->currentIndex();
+    if (level1Index < 0 || level1Index >= m_categories.size()) {
+        m_selectionTimer->stop();
+        return;
+    }
+
+    m_pendingLevel1Index = level1Index;
+    m_pendingLevel2Index = m_categories.at(level1Index).currentItem;
+}
+
+bool MenuWidget::hasStableIds() const
+{
+    return m_model && m_model->index(0, 0).data(MenuModel::IdRole).isValid();
+}
+
+MenuWidget::ContentKey MenuWidget::contentKey(int level1Index, int level2Index) const
+{
+    if (!m_model || level1Index < 0 || level1Index >= m_categories.size()
+            || level2Index < 0 || level2Index >= m_categories.at(level1Index).itemCount) {
+        return 0;
+    }
+
+    QModelIndex itemIndex = m_model->index(level2Index, 0, m_model->index(level1Index, 0));
+    QVariant id = itemIndex.data(MenuModel::IdRole);
+    if (id.isValid()) {
+        return id.value<TabId>();
+    }
+
+    // Positions are stable as long as such models only grow at the end
+    return (quint64(level1Index + 1) << 32) | quint32(level2Index + 1);
+}
+
+void MenuWidget::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                               const QVector<int> &roles)
+{
+    if (!m_model || !topLeft.isValid() || !bottomRight.isValid()) {
+        return;
+    }
+
+    // Only labels are displayed
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole)) {
+        return;
+    }
+
+    // Level 2 strips relabel themselves, only categories are handled here
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+
+    int first = topLeft.row();
+    int last = qMin(bottomRight.row(), m_level1TabBar->count() - 1);
+
+    // Each label change repaints the bar; a bulk relabel repaints it once,
+    // keeping the bar visible and any focus it has
+    bool bulk = last > first;
+    if (bulk) {
+        m_level1TabBar->setUpdatesEnabled(false);
+    }
+    for (int row = first; row <= last; ++row) {
+        m_level1TabBar->setTabText(row, m_model->index(row, 0).data(Qt::DisplayRole).toString());
+    }
+    if (bulk) {
+        m_level1TabBar->setUpdatesEnabled(true);
+        m_level1TabBar->updateGeometry();
+    }
+}
+
+void MenuWidget::rebuildFromModel()
+{
+    clearView();
+
+    // Pre-built content waits for its model to come back
+    if (!m_model) {
         return;
     }
+    rekeyPrebuiltContent();
+
+    // Existing items are selected silently, the result is reported once
+    int categoryCount = m_model->rowCount();
+    if (categoryCount > 0) {
+        m_level1TabBar->blockSignals(true);
+        insertCategories(0, categoryCount - 1);
+        m_level1TabBar->blockSignals(false);
+    }
+
+    int level1Index = m_level1TabBar->currentIndex();
+    showCategory(level1Index);
+
+    if (level1Index >= 0 && m_level2TabStrip->currentIndex() >= 0) {
+        reportSelection(level1Index, m_level2TabStrip->currentIndex());
+    }
+}
+
+void MenuWidget::insertCategories(int first, int last)
+{
+    // Categories inserted before the shown one renumber it
+    if (m_shownCategory >= first) {
+        m_shownCategory += last - first + 1;
+    }
+
+    // While updating, endUpdate() shows the tab that became current
+    bool blocked = m_level1TabBar->signalsBlocked();
+    if (m_updateDepth > 0) {
+        m_level1TabBar->blockSignals(true);
+    }
+
+    for (int level1Index = first; level1Index <= last; ++level1Index) {
+        m_categories.insert(level1Index, Category());
+
+        // A category may arrive with its items already in the model
+        QModelIndex categoryIndex = m_model->index(level1Index, 0);
+        int itemCount = m_model->rowCount(categoryIndex);
+        if (itemCount > 0) {
+            insertItems(level1Index, 0, itemCount - 1);
+        }
+
+        // Add tab to level 1 tab bar; the first one becomes current and
+        // shows its items in the level 2 strip
+        m_level1TabBar->insertTab(level1Index, categoryIndex.data(Qt::DisplayRole).toString());
+    }
+
+    m_level1TabBar->blockSignals(blocked);
+}
+
+void MenuWidget::insertItems(int level1Index, int first, int last)
+{
+    // The tabs themselves are added by the level 2 strip when it shows
+    // this category; it is notified after us, so when its first tab
+    // becomes current the count below is already up to date. Entries
+    // are only created for items that get content.
+    Category &category = m_categories[level1Index];
+    int inserted = last - first + 1;
+    category.itemCount += inserted;
+
+    if (category.currentItem < 0) {
+        category.currentItem = 0;
+    } else if (category.currentItem >= first) {
+        category.currentItem += inserted;
+    }
+
+    if (m_pendingWidget) {
+        m_contentEntries[contentKey(level1Index, first)].widget = m_pendingWidget;
+        m_pendingWidget = nullptr;
+    }
+}
+
+void MenuWidget::clearView()
+{
+    // Lazily built widgets belong to this view and are built again on
+    // demand; pre-built ones cannot be, so they stay keyed by their item
+    auto it = m_contentEntries.begin();
+    while (it != m_contentEntries.end()) {
+        if (it->lazy) {
+            delete it->widget.data();
+        }
+        if (it->widget && !it->lazy && !it->recycled) {
+            ++it;
+        } else {
+            it = m_contentEntries.erase(it);
+        }
+    }
+    releaseContentPools();
+
+    // A held back selection refers to the old tabs
+    m_selectionTimer->stop();
+
+    m_categories.clear();
+    m_shownCategory = -1;
+    m_contentLru.clear();
+    m_savedStates.clear();
+    m_builtContentBytes = 0;
+
+    m_level1TabBar->blockSignals(true);
+    while (m_level1TabBar->count() > 0) {
+        m_level1TabBar->removeTab(m_level1TabBar->count() - 1);
+    }
+    m_level1TabBar->blockSignals(false);
+
+    m_level2TabStrip->blockSignals(true);
+    m_level2TabStrip->setModel(nullptr);
+    m_level2TabStrip->blockSignals(false);
+}
 
-    // Get the corresponding level 2 tab bar
-    QTabBar *level2TabBar = m_level2TabBars[level1Index];
+void MenuWidget::rekeyPrebuiltContent()
+{
+    // Content kept through a rebuild follows its item by id; keys that
+    // were positions, or ids of another model or of items gone in the
+    // reset, are dropped as if their items were removed
+    bool sameIds = m_keyedModel == m_model && hasStableIds();
+    MenuModel *menu = menuModel();
+
+    QVector<ContentKey> stale;
+    for (auto it = m_contentEntries.constBegin(); it != m_contentEntries.constEnd(); ++it) {
+        if (!sameIds || (menu && !menu->indexForId(it.key()).isValid())) {
+            stale.append(it.key());
+        }
+    }
+    dropContent(stale);
 
-    // Get the index for the new level 2 tab
-    int level2Index = level2TabBar->count();
+    m_keyedModel = m_model;
+}
 
-    // Add tab to level 2 tab bar
-    level2TabBar->addTab(tabName);
+void MenuWidget::showCategory(int level1Index)
+{
+    // Remember where the strip was scrolled to for the category we leave
+    if (m_shownCategory >= 0 && m_shownCategory < m_categories.size()) {
+        m_categories[m_shownCategory].scrollOffset = m_level2TabStrip->scrollOffset();
+    }
 
-    // Store the mapping of level 2 tab index to content widget
-    m_contentWidgets[level2TabBar][level2Index] = contentWidget;
+    m_level2TabStrip->blockSignals(true);
 
-    // If this is the first level 2 tab for the current level 1 tab, set it as current
-    if (level2Index == 0) {
-        level2TabBar->setCurrentIndex(0);
-        // Emit signal
-        emit tabSelectionChanged(level1Index, 0);
+    if (m_model && level1Index >= 0 && level1Index < m_categories.size()) {
+        // Re-rooting only resets the strip's width cache, labels are
+        // measured lazily when the visible tabs are painted
+        const Category &category = m_categories.at(level1Index);
+        m_level2TabStrip->setModel(m_model, m_model->index(level1Index, 0));
+        m_level2TabStrip->setCurrentIndex(category.currentItem);
+        m_level2TabStrip->setScrollOffset(category.scrollOffset);
+        m_shownCategory = level1Index;
+    } else {
+        m_level2TabStrip->setModel(nullptr);
+        m_shownCategory = -1;
     }
+
+    m_level2TabStrip->blockSignals(false);
 }
 
 void MenuWidget::onLevel1TabChanged(int index)
 {
-    // Switch to the corresponding level 2 tab bar
-    if (m_level2TabBars.contains(index)) {
-        QTabBar *level2TabBar = m_level2TabBars[index];
-        m_level2Container->show(level2TabBar);
+    TRACE_SPAN("MenuWidget::onLevel1TabChanged");
+
+    // Show the items of the corresponding category in the level 2 strip
+    if (index >= 0 && index < m_categories.size()) {
+        showCategory(index);
 
         // Get current level 2 index and emit signal
-        int currentLevel2Index = level2TabBar->currentIndex();
+        int currentLevel2Index = m_level2TabStrip->currentIndex();
         if (currentLevel2Index >= 0) {
-            emit tabSelectionChanged(index, currentLevel2Index);
+            reportSelection(index, currentLevel2Index);
         }
     }
 }
 
 void MenuWidget::onLevel2TabChanged(int index)
 {
-    // Get the current level 2 tab bar
-    QTabBar *level2TabBar = qobject_cast<QTabBar*>(sender());
-    if (!level2TabBar) {
-        return;
-    }
+    TRACE_SPAN("MenuWidget::onLevel2TabChanged");
 
-    // Find the level 1 index for this level 2 tab bar
-    int level1Index = -1;
-    for (auto it = m_level2TabBars.begin(); it != m_level2TabBars.end(); ++it) {
-        if (it.value() == level2TabBar) {
-            level1Index = it.key();
-            break;
+    // The strip always shows the current category
+    int level1Index = m_shownCategory;
+
+    if (level1Index >= 0) {
+        // Remembered for when the category is shown again
+        if (index >= 0) {
+            m_categories[level1Index].currentItem = index;
         }
+        reportSelection(level1Index, index);
     }
+}
 
-    if (level1Index >= 0) {
-        emit tabSelectionChanged(level1Index, index);
+MenuWidget::ContentEntry *MenuWidget::findContentEntry(ContentKey key) const
+{
+    auto it = m_contentEntries.find(key);
+    return it == m_contentEntries.end() ? nullptr : &it.value();
+}
+
+MenuWidget::ContentFactory MenuWidget::contentFactory(int level1Index, int level2Index) const
+{
+    if (!m_model) {
+        return ContentFactory();
     }
+
+    QModelIndex itemIndex = m_model->index(level2Index, 0, m_model->index(level1Index, 0));
+    ContentFactory factory = itemIndex.data(MenuModel::ContentFactoryRole).value<ContentFactory>();
+    if (factory) {
+        return factory;
+    }
+
+    // Catalogs loaded from data describe content as text
+    QVariant text = itemIndex.data(MenuModel::ContentTextRole);
+    if (!text.isValid()) {
+        return ContentFactory();
+    }
+
+    QString content = text.toString();
+    return [content]() { return new CustomWidget(content); };
 }
 
 CustomWidget* MenuWidget::getContentWidget(int level1Index, int level2Index) const
 {
-    if (!m_level2TabBars.contains(level1Index)) {
+    ContentKey key = contentKey(level1Index, level2Index);
+    if (!key) {
         return nullptr;
     }
 
-    QTabBar *level2TabBar = m_level2TabBars[level1Index];
-    if (!m_contentWidgets.contains(level2TabBar)) {
+    ContentEntry *entry = findContentEntry(key);
+    if (entry && entry->widget) {
+        // Pre-built widgets cannot be rebuilt, so they are never tracked for eviction
+        if (entry->lazy) {
+            // Mark as most recently used
+            m_contentLru.splice(m_contentLru.end(), m_contentLru, entry->lruPosition);
+        } else if (entry->recycled) {
+            // Last to be rebound
+            for (QList<CustomWidget*> &pool : m_contentPools) {
+                if (pool.removeOne(entry->widget)) {
+                    pool.append(entry->widget);
+                    break;
+                }
+            }
+        }
+        return entry->widget;
+    }
+
+    if (m_recyclingPoolSize > 0) {
+        if (CustomWidget *widget = recycledContentWidget(level1Index, level2Index)) {
+            return widget;
+        }
+    }
+
+    // Build lazy content the first time it is requested (or after eviction)
+    ContentFactory factory = contentFactory(level1Index, level2Index);
+    if (!factory) {
         return nullptr;
     }
 
-    if (!m_contentWidgets[level2TabBar].contains(level2Index)) {
+    CustomWidget *widget;
+    {
+        TRACE_SPAN("MenuWidget::buildContent");
+        widget = factory();
+    }
+
+    // The factory may have changed the catalog, check the item is still there
+    if (!widget || contentKey(level1Index, level2Index) != key) {
+        return widget;
+    }
+
+    // A widget deleted elsewhere left its entry behind
+    entry = &m_contentEntries[key];
+    if (entry->lazy) {
+        m_builtContentBytes -= entry->estimatedBytes;
+        m_contentLru.erase(entry->lruPosition);
+    }
+    entry->widget = widget;
+    entry->lazy = true;
+
+    if (m_savedStates.contains(key)) {
+        QVariant state = m_savedStates.take(key);
+        if (m_stateRestorer) {
+            m_stateRestorer(entry->widget, state);
+        }
+    }
+
+    entry->estimatedBytes = estimateContentBytes(entry->widget);
+    m_builtContentBytes += entry->estimatedBytes;
+    entry->lruPosition = m_contentLru.insert(m_contentLru.end(), key);
+
+    if (isOverContentBudget()) {
+        m_trimTimer->start();
+    }
+
+    return entry->widget;
+}
+
+CustomWidget *MenuWidget::recycledContentWidget(int level1Index, int level2Index) const
+{
+    if (!m_model) {
+        return nullptr;
+    }
+
+    // Factory items are opaque, only items described as data are recycled
+    QModelIndex itemIndex = m_model->index(level2Index, 0, m_model->index(level1Index, 0));
+    if (itemIndex.data(MenuModel::ContentFactoryRole).value<ContentFactory>()
+        || !itemIndex.data(MenuModel::ContentTextRole).isValid()) {
         return nullptr;
     }
 
-    return m_contentWidgets[level2TabBar][level2Index];
+    QString typeName = itemIndex.data(MenuModel::ContentTypeRole).toString();
+    ContentType type = m_contentTypes.value(typeName);
+    QList<CustomWidget*> &pool = m_contentPools[typeName];
+
+    // Rebind the least recently bound widget no area shows, once the pool
+    // is full
+    CustomWidget *widget = nullptr;
+    if (pool.size() >= m_recyclingPoolSize) {
+        for (int i = 0; i < pool.size(); ++i) {
+            CustomWidget *candidate = pool.at(i);
+            ContentKey previousKey = m_recycledKeys.value(candidate, 0);
+            ContentEntry *previous = findContentEntry(previousKey);
+            bool bound = previous && previous->widget == candidate;
+
+            if (!candidate->isHidden() || (bound && previous->pinned)) {
+                continue;
+            }
+
+            if (bound) {
+                if (m_stateSaver) {
+                    m_savedStates.insert(previousKey, m_stateSaver(candidate));
+                }
+                m_contentEntries.remove(previousKey);
+            }
+
+            widget = candidate;
+            pool.removeAt(i);
+            break;
+        }
+    }
+
+    // Below the pool size, or every widget is on screen
+    if (!widget) {
+        TRACE_SPAN("MenuWidget::buildContent");
+        widget = type.create ? type.create() : new CustomWidget(QString());
+        if (!widget) {
+            return nullptr;
+        }
+
+        // Pooled widgets may be deleted along with the area showing them
+        connect(widget, &QObject::destroyed, this, [this, widget, typeName]() {
+            auto pool = m_contentPools.find(typeName);
+            if (pool != m_contentPools.end()) {
+                pool->removeOne(widget);
+            }
+            m_recycledKeys.remove(widget);
+        });
+    }
+
+    {
+        TRACE_SPAN("MenuWidget::bindContent");
+        if (type.bind) {
+            type.bind(widget, itemIndex);
+        } else {
+            widget->setText(itemIndex.data(MenuModel::ContentTextRole).toString());
+        }
+    }
+
+    ContentKey key = contentKey(level1Index, level2Index);
+    pool.append(widget);
+    m_recycledKeys.insert(widget, key);
+
+    // The binder may have changed the catalog
+    if (!key) {
+        return widget;
+    }
+
+    ContentEntry *entry = &m_contentEntries[key];
+    entry->widget = widget;
+    entry->lazy = false;
+    entry->recycled = true;
+
+    if (m_savedStates.contains(key)) {
+        QVariant state = m_savedStates.take(key);
+        if (m_stateRestorer) {
+            m_stateRestorer(widget, state);
+        }
+    }
+
+    return widget;
+}
+
+void MenuWidget::releaseContentPools()
+{
+    // Pools only hold live widgets, taken out first as deleting them
+    // updates the pools
+    QHash<QString, QList<CustomWidget*> > pools;
+    pools.swap(m_contentPools);
+    m_recycledKeys.clear();
+
+    for (const QList<CustomWidget*> &pool : pools) {
+        for (CustomWidget *widget : pool) {
+            widget->disconnect(this);
+            deleteFromContainer(widget);
+        }
+    }
+}
+
+void MenuWidget::setContentRecycling(int poolSize)
+{
+    poolSize = qMax(0, poolSize);
+    if (poolSize == m_recyclingPoolSize) {
+        return;
+    }
+    m_recyclingPoolSize = poolSize;
+
+    if (poolSize > 0) {
+        return;
+    }
+
+    // Bound widgets stay with their items as ordinary lazily built ones,
+    // the rest are no longer needed
+    QHash<QString, QList<CustomWidget*> > pools;
+    pools.swap(m_contentPools);
+    for (const QList<CustomWidget*> &pool : pools) {
+        for (CustomWidget *widget : pool) {
+            widget->disconnect(this);
+
+            ContentKey key = m_recycledKeys.value(widget, 0);
+            ContentEntry *entry = findContentEntry(key);
+            if (!entry || entry->widget != widget) {
+                deleteFromContainer(widget);
+                continue;
+            }
+
+            entry->recycled = false;
+            entry->lazy = true;
+            entry->estimatedBytes = estimateContentBytes(widget);
+            m_builtContentBytes += entry->estimatedBytes;
+            entry->lruPosition = m_contentLru.insert(m_contentLru.end(), key);
+        }
+    }
+    m_recycledKeys.clear();
+
+    if (isOverContentBudget()) {
+        m_trimTimer->start();
+    }
+}
+
+int MenuWidget::contentRecycling() const
+{
+    return m_recyclingPoolSize;
+}
+
+void MenuWidget::setContentType(const QString &type, const ContentFactory &create, const ContentBinder &bind)
+{
+    ContentType contentType;
+    contentType.create = create;
+    contentType.bind = bind;
+    m_contentTypes.insert(type, contentType);
+}
+
+int MenuWidget::recycledContentCount() const
+{
+    int count = 0;
+    for (const QList<CustomWidget*> &pool : m_contentPools) {
+        count += pool.size();
+    }
+    return count;
+}
+
+void MenuWidget::setContentBudget(int maxWidgets, qint64 maxBytes)
+{
+    m_maxContentWidgets = qMax(0, maxWidgets);
+    m_maxContentBytes = qMax<qint64>(0, maxBytes);
+
+    if (isOverContentBudget()) {
+        m_trimTimer->start();
+    }
+}
+
+void MenuWidget::setContentSizeEstimator(const ContentSizeEstimator &estimator)
+{
+    m_sizeEstimator = estimator;
+}
+
+void MenuWidget::setContentStateHooks(const ContentStateSaver &saver, const ContentStateRestorer &restorer)
+{
+    m_stateSaver = saver;
+    m_stateRestorer = restorer;
+}
+
+void MenuWidget::setContentPinned(int level1Index, int level2Index, bool pinned)
+{
+    ContentKey key = contentKey(level1Index, level2Index);
+    if (!key) {
+        return;
+    }
+
+    // An unpinned entry without content has nothing left to keep
+    ContentEntry &entry = m_contentEntries[key];
+    entry.pinned = pinned;
+    if (!pinned && !entry.widget) {
+        m_contentEntries.remove(key);
+    }
+
+    // Unpinning may leave us over budget
+    if (!pinned && isOverContentBudget()) {
+        m_trimTimer->start();
+    }
+}
+
+QByteArray MenuWidget::saveState() const
+{
+    // Categories still on their first item and unscrolled are restored
+    // as such anyway, only the others carry state
+    QVector<int> visited;
+    for (int i = 0; i < m_categories.size(); ++i) {
+        const Category &category = m_categories.at(i);
+        if (category.currentItem > 0 || category.scrollOffset != 0 || i == m_shownCategory) {
+            visited.append(i);
+        }
+    }
+
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << StateMagic << StateVersion << qint32(m_level1TabBar->currentIndex()) << qint32(visited.size());
+    for (int i : visited) {
+        const Category &category = m_categories.at(i);
+
+        // The shown category's scroll position lives in the strip
+        int scrollOffset = i == m_shownCategory ? m_level2TabStrip->scrollOffset() : category.scrollOffset;
+        stream << qint32(i) << qint32(category.currentItem) << qint32(scrollOffset);
+    }
+
+    return state;
+}
+
+bool MenuWidget::restoreState(const QByteArray &state)
+{
+    QDataStream stream(state);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint8 version = 0;
+    qint32 level1Index = -1;
+    qint32 count = 0;
+    stream >> magic >> version >> level1Index >> count;
+    if (stream.status() != QDataStream::Ok || magic != StateMagic || version != StateVersion || count < 0) {
+        return false;
+    }
+
+    // Read everything before changing anything
+    QVector<qint32> entries;
+    entries.reserve(qMin(count, 1 << 16) * 3);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 index, currentItem, scrollOffset;
+        stream >> index >> currentItem >> scrollOffset;
+        entries << index << currentItem << scrollOffset;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // Keep showCategory() from saving the strip's position over the
+    // restored one
+    int shownCategory = m_shownCategory;
+    m_shownCategory = -1;
+
+    for (int i = 0; i < entries.size(); i += 3) {
+        int index = entries.at(i);
+        if (index < 0 || index >= m_categories.size()) {
+            continue;
+        }
+
+        Category &category = m_categories[index];
+        int currentItem = entries.at(i + 1);
+        if (currentItem >= 0 && currentItem < category.itemCount) {
+            category.currentItem = currentItem;
+        }
+        category.scrollOffset = qMax(0, int(entries.at(i + 2)));
+    }
+
+    if (level1Index >= 0 && level1Index < m_categories.size()) {
+        // A negative level 2 index keeps the restored current item
+        setCurrentTabs(level1Index, -1);
+    } else {
+        showCategory(shownCategory);
+    }
+    return true;
+}
+
+int MenuWidget::builtContentCount() const
+{
+    return int(m_contentLru.size());
+}
+
+bool MenuWidget::isOverContentBudget() const
+{
+    if (m_maxContentWidgets > 0 && int(m_contentLru.size()) > m_maxContentWidgets) {
+        return true;
+    }
+
+    return m_maxContentBytes > 0 && m_builtContentBytes > m_maxContentBytes;
+}
+
+qint64 MenuWidget::estimateContentBytes(CustomWidget *widget) const
+{
+    if (m_sizeEstimator) {
+        return m_sizeEstimator(widget);
+    }
+
+    // Rough default: a 32-bit backing surface at the preferred size plus
+    // a fixed cost for every child object
+    QSize size = widget->sizeHint().expandedTo(QSize(1, 1));
+    qint64 childCount = widget->findChildren<QObject*>().size();
+    return qint64(size.width()) * size.height() * 4 + (childCount + 1) * 1024;
+}
+
+void MenuWidget::trimContentWidgets()
+{
+    // Walk from least to most recently used and evict until within budget
+    ContentLru::iterator it = m_contentLru.begin();
+    while (it != m_contentLru.end() && isOverContentBudget()) {
+        const ContentKey key = *it;
+        ContentEntry *entry = findContentEntry(key);
+
+        // Deleted elsewhere, only the bookkeeping is left
+        if (!entry || !entry->widget) {
+            if (entry) {
+                m_builtContentBytes -= entry->estimatedBytes;
+                m_contentEntries.remove(key);
+            }
+            it = m_contentLru.erase(it);
+            continue;
+        }
+
+        // Keep pinned widgets and anything currently shown in an area
+        if (entry->pinned || !entry->widget->isHidden()) {
+            ++it;
+            continue;
+        }
+
+        if (m_stateSaver) {
+            m_savedStates.insert(key, m_stateSaver(entry->widget));
+        }
+
+        m_builtContentBytes -= entry->estimatedBytes;
+
+        // Containers drop destroyed widgets on their own
+        delete entry->widget.data();
+        m_contentEntries.remove(key);
+
+        it = m_contentLru.erase(it);
+    }
 }
 
 void MenuWidget::setCurrentTabs(int level1Index, int level2Index)
@@ -144,25 +1340,51 @@ void MenuWidget::setCurrentTabs(int level1Index, int level2Index)
         return;
     }
 
+    // The caller decides the selection, drop any held back one
+    m_selectionTimer->stop();
+
     // Block signals to avoid triggering tabSelectionChanged
     m_level1TabBar->blockSignals(true);
     m_level1TabBar->setCurrentIndex(level1Index);
     m_level1TabBar->blockSignals(false);
 
-    // Show the corresponding level 2 tab bar
-    if (m_level2TabBars.contains(level1Index)) {
-        QTabBar *level2TabBar = m_level2TabBars[level1Index];
-        m_level2Container->show(level2TabBar);
-
+    // Show the corresponding category in the level 2 strip
+    if (level1Index < m_categories.size()) {
         // Validate and set level 2 index
-        if (level2Index >= 0 && level2Index < level2TabBar->count()) {
-            level2TabBar->blockSignals(true);
-            level2TabBar->setCurrentIndex(level2Index);
-            level2TabBar->blockSignals(false);
+        Category &category = m_categories[level1Index];
+        if (level2Index >= 0 && level2Index < category.itemCount) {
+            category.currentItem = level2Index;
         }
+
+        showCategory(level1Index);
+    }
+}
+
+void MenuWidget::activateTabs(int level1Index, int level2Index)
+{
+    if (level1Index < 0 || level1Index >= m_categories.size()) {
+        return;
+    }
+
+    setCurrentTabs(level1Index, level2Index);
+
+    // The strip restored the category's scroll position, bring the tab into view
+    int currentLevel2Index = m_level2TabStrip->currentIndex();
+    if (currentLevel2Index >= 0) {
+        m_level2TabStrip->ensureTabVisible(currentLevel2Index);
+        reportSelection(level1Index, currentLevel2Index);
     }
 }
 
+SearchIndex *MenuWidget::searchIndex()
+{
+    if (!m_searchIndex) {
+        m_searchIndex = new SearchIndex(this);
+        m_searchIndex->setModel(m_model);
+    }
+    return m_searchIndex;
+}
+
 void MenuWidget::setLevel1TabText(int level1Index, const QString &newText)
 {
     // Validate level 1 index
@@ -170,24 +1392,44 @@ void MenuWidget::setLevel1TabText(int level1Index, const QString &newText)
         return;
     }
 
-    // Set the new text for the tab
-    m_level1TabBar->setTabText(level1Index, newText);
+    // The model notifies every view showing it, including this one
+    if (m_model) {
+        m_model->setData(m_model->index(level1Index, 0), newText, Qt::EditRole);
+    }
 }
 
-void MenuWidget::setLevel2TabText(int level1Index, int level2Index, const QString &newText)
+void MenuWidget::setTabTexts(const QVector<TabTextChange> &changes)
 {
-    // Validate level 1 index and check if level 2 tab bar exists
-    if (!m_level2TabBars.contains(level1Index)) {
+    if (MenuModel *menu = menuModel()) {
+        menu->setLabels(changes);
         return;
     }
 
-    QTabBar *level2TabBar = m_level2TabBars[level1Index];
+    // Other models are relabeled one index at a time
+    for (const TabTextChange &change : changes) {
+        if (change.item < 0) {
+            setLevel1TabText(change.category, change.label);
+        } else {
+            setLevel2TabText(change.category, change.item, change.label);
+        }
+    }
+}
+
+void MenuWidget::setLevel2TabText(int level1Index, int level2Index, const QString &newText)
+{
+    // Validate level 1 index
+    if (level1Index < 0 || level1Index >= m_categories.size()) {
+        return;
+    }
 
     // Validate level 2 index
-    if (level2Index < 0 || level2Index >= level2TabBar->count()) {
+    if (level2Index < 0 || level2Index >= m_categories.at(level1Index).itemCount) {
         return;
     }
 
-    // Set the new text for the tab
-    level2TabBar->setTabText(level2Index, newText);
+    // The model notifies every view showing it, including this one
+    if (m_model) {
+        QModelIndex itemIndex = m_model->index(level2Index, 0, m_model->index(level1Index, 0));
+        m_model->setData(itemIndex, newText, Qt::EditRole);
+    }
 }
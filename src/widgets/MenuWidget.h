@@ -4,55 +4,318 @@
 #include <QWidget>
 #include <QTabBar>
 #include <QVBoxLayout>
-#include <QMap>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QTimer>
+#include <QVariant>
+#include <QPointer>
+#include <functional>
+#include <list>
 #include "CustomWidget.h"
 #include "Container.h"
+#include "TabStrip.h"
+#include "../model/MenuModel.h"
+
+class SearchIndex;
 
 class MenuWidget : public QWidget
 {
     Q_OBJECT
 
 public:
+    // Builds the content widget of a level 2 tab the first time it is needed
+    typedef MenuModel::ContentFactory ContentFactory;
+
+    // Estimates the memory used by a built content widget, in bytes
+    typedef std::function<qint64(CustomWidget*)> ContentSizeEstimator;
+
+    // Save/restore user-visible state so eviction and rebuild are invisible
+    typedef std::function<QVariant(CustomWidget*)> ContentStateSaver;
+    typedef std::function<void(CustomWidget*, const QVariant&)> ContentStateRestorer;
+
+    // Stable id of a tab (MenuModel::Id), unchanged while other tabs are
+    // inserted, removed or moved
+    typedef MenuModel::Id TabId;
+
+    // Rebinds a recycled content widget to the item at index
+    typedef std::function<void(CustomWidget*, const QModelIndex&)> ContentBinder;
+
+    // (level1, level2, text) rename for setTabTexts(); a negative level 2
+    // index renames the level 1 tab
+    typedef MenuModel::LabelChange TabTextChange;
+
     explicit MenuWidget(QWidget *parent = nullptr);
     ~MenuWidget();
 
+    // Display another catalog. Categories are top-level rows, items their
+    // children; a MenuModel may be shared by several MenuWidgets.
+    void setModel(QAbstractItemModel *model);
+    QAbstractItemModel *model() const;
+
+    // The model as a MenuModel, or nullptr if it is another model type
+    MenuModel *menuModel() const;
+
     // Add a level 1 tab
     void addLevel1Tab(const QString &tabName);
 
-    // Add a level 2 tab with one content widget
+    // Add a level 2 tab with one content widget (the widget stays local to this view)
     void addLevel2Tab(int level1Index, const QString &tabName, CustomWidget *contentWidget);
 
-    // Get content widget for given indices
+    // Add a level 2 tab whose content widget is built lazily by the factory
+    void addLevel2Tab(int level1Index, const QString &tabName, const ContentFactory &factory);
+
+    // Add several level 2 tabs in one step; tabs without a matching factory have no content
+    void addLevel2Tabs(int level1Index, const QStringList &tabNames,
+                       const QList<ContentFactory> &factories);
+
+    // Remove a level 1 tab with its level 2 tabs, or a level 2 tab. Their
+    // lazily built content widgets are destroyed; a removed current tab
+    // is replaced by its neighbour, reported by tabSelectionChanged().
+    void removeLevel1Tab(int level1Index);
+    void removeLevel2Tab(int level1Index, int level2Index);
+
+    // Move a level 1 tab, or a level 2 tab within its level 1 tab, so it
+    // ends up at index to. Content widgets and the selection move along.
+    void moveLevel1Tab(int from, int to);
+    void moveLevel2Tab(int level1Index, int from, int to);
+
+    // Id of a tab, 0 for invalid indices or models without
+    // MenuModel::IdRole. Content widgets are kept by id, so removing or
+    // moving tabs costs O(log n) with a MenuModel.
+    TabId level1TabId(int level1Index) const;
+    TabId level2TabId(int level1Index, int level2Index) const;
+
+    // Current indices of the tab with an id (level 2 index -1 for a level
+    // 1 tab); false if it was removed or the model is not a MenuModel
+    bool findTab(TabId id, int *level1Index, int *level2Index) const;
+
+    // Group changes to the menu: layouts, repaints and tabSelectionChanged()
+    // are held back until the matching endUpdate(), which reports the
+    // resulting selection once. Calls may be nested.
+    void beginUpdate();
+    void endUpdate();
+
+    // Coalesce tabSelectionChanged() during rapid navigation: the tabs
+    // follow input at once, but the signal is only emitted once the
+    // selection has been stable for msec milliseconds, so only the tab
+    // the user settles on has its content built and shown (0 = off)
+    void setSelectionCoalescing(int msec);
+    int selectionCoalescing() const;
+
+    // Emit a selection held back by coalescing right away
+    void flushPendingSelection();
+
+    // Selections superseded before they were emitted
+    int skippedSelectionCount() const;
+
+    // Get content widget for given indices (builds it on first access)
     CustomWidget* getContentWidget(int level1Index, int level2Index) const;
 
+    // Limit the lazily built content widgets kept alive (0 = unlimited).
+    // Least recently used widgets that are not displayed are destroyed
+    // and rebuilt by their factory on the next getContentWidget() call.
+    void setContentBudget(int maxWidgets, qint64 maxBytes = 0);
+
+    // Replace the default size estimate used for the byte budget
+    void setContentSizeEstimator(const ContentSizeEstimator &estimator);
+
+    // Hooks called before a widget is evicted and after it is rebuilt
+    void setContentStateHooks(const ContentStateSaver &saver, const ContentStateRestorer &restorer);
+
+    // Pinned content widgets are never evicted
+    void setContentPinned(int level1Index, int level2Index, bool pinned);
+
+    // Number of lazily built content widgets currently alive (recycled
+    // widgets are counted by recycledContentCount())
+    int builtContentCount() const;
+
+    // Recycle the content widgets of items described as data
+    // (MenuModel::ContentTextRole) like list view cells: up to poolSize
+    // widgets are built per content type (MenuModel::ContentTypeRole),
+    // then the least recently bound one no area shows is rebound to the
+    // next item that needs a widget. More are built only while all are
+    // on screen. 0, the default, builds one widget per item; pooled
+    // widgets then become ordinary lazily built ones.
+    void setContentRecycling(int poolSize);
+    int contentRecycling() const;
+
+    // How widgets of a content type are built and rebound. A type without
+    // this gets a CustomWidget rebound through setText().
+    void setContentType(const QString &type, const ContentFactory &create, const ContentBinder &bind);
+
+    // Number of widgets in the recycling pools
+    int recycledContentCount() const;
+
     // Set current tab indices (without emitting signals)
     void setCurrentTabs(int level1Index, int level2Index);
 
+    // Select tabs as a click would, emitting tabSelectionChanged(); a
+    // negative level 2 index keeps the category's current item
+    void activateTabs(int level1Index, int level2Index);
+
+    // Index over all tab labels for type-ahead search, created on first
+    // use and kept up to date with the model from then on
+    SearchIndex *searchIndex();
+
+    // Selected category and the last selected item and scroll position
+    // of every category, as a compact binary blob. Restoring selects
+    // without emitting tabSelectionChanged() and builds no content;
+    // entries outside the current catalog are ignored.
+    QByteArray saveState() const;
+    bool restoreState(const QByteArray &state);
+
     // Rename a level 1 tab (category)
     void setLevel1TabText(int level1Index, const QString &newText);
 
     // Rename a level 2 tab (item)
     void setLevel2TabText(int level1Index, int level2Index, const QString &newText);
 
+    // Rename many tabs in one pass (invalid entries are ignored); only the
+    // tabs whose labels changed are repainted
+    void setTabTexts(const QVector<TabTextChange> &changes);
+
 signals:
     // Emitted when tab selection changes
     void tabSelectionChanged(int level1Index, int level2Index);
 
+    // Emitted after tabs were removed or moved; indices held elsewhere
+    // should be looked up again with findTab()
+    void tabsRearranged();
+
 private slots:
     void onLevel1TabChanged(int index);
     void onLevel2TabChanged(int index);
+    void trimContentWidgets();
+    void emitPendingSelection();
+
+    // Model notifications
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsMoved(const QModelIndex &parent, int start, int end,
+                     const QModelIndex &destination, int row);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                       const QVector<int> &roles);
+    void rebuildFromModel();
 
 private:
+    // The item's TabId, or its position for models without ids (0 for
+    // invalid indices)
+    typedef quint64 ContentKey;
+
+    // Lazily built widgets, least recently used first; a list so an entry
+    // is moved or removed through its own position without a search
+    typedef std::list<ContentKey> ContentLru;
+
+    // View-side state of a level 2 tab; labels and factories live in the model
+    struct ContentEntry {
+        ContentEntry() : estimatedBytes(0), pinned(false), lazy(false), recycled(false) {}
+
+        // Cleared when the widget is deleted elsewhere, e.g. with the area
+        // that shows it
+        QPointer<CustomWidget> widget;
+        qint64 estimatedBytes;
+        bool pinned;
+        bool lazy;      // Built by the model's factory, so it may be evicted
+        bool recycled;  // Bound from a recycling pool, which owns the widget
+        ContentLru::iterator lruPosition;  // Valid for lazy entries only
+    };
+
+    // One row of the menu: its item count and the state of the shared
+    // level 2 strip to restore when it is shown again
+    struct Category {
+        Category() : itemCount(0), currentItem(-1), scrollOffset(0) {}
+
+        int itemCount;
+        int currentItem;
+        int scrollOffset;
+    };
+
+    void insertCategories(int first, int last);
+    void insertItems(int level1Index, int first, int last);
+    void dropContent(const QVector<ContentKey> &keys);
+    void updatePendingSelection();
+    bool hasStableIds() const;
+    ContentKey contentKey(int level1Index, int level2Index) const;
+    ContentEntry *findContentEntry(ContentKey key) const;
+    void clearView();
+    void rekeyPrebuiltContent();
+    void showCategory(int level1Index);
+    void reportSelection(int level1Index, int level2Index);
+    void dispatchSelection(int level1Index, int level2Index);
+    ContentFactory contentFactory(int level1Index, int level2Index) const;
+    CustomWidget *recycledContentWidget(int level1Index, int level2Index) const;
+    void releaseContentPools();
+    bool isOverContentBudget() const;
+    qint64 estimateContentBytes(CustomWidget *widget) const;
+
     QVBoxLayout *m_mainLayout;
     QTabBar *m_level1TabBar;
     Container *m_level2Container;
 
-    // Map to store level 2 tab bars for each level 1 tab
-    QMap<int, QTabBar*> m_level2TabBars;
+    // One level 2 strip for all categories, re-rooted on the shown one
+    TabStrip *m_level2TabStrip;
+    int m_shownCategory;
+
+    QPointer<QAbstractItemModel> m_model;
+
+    // Model whose ids the content entries are keyed by
+    QPointer<QAbstractItemModel> m_keyedModel;
+
+    // Created by searchIndex()
+    SearchIndex *m_searchIndex;
+
+    // Pre-built widget handed to the next item inserted by addLevel2Tab()
+    CustomWidget *m_pendingWidget;
+
+    // beginUpdate() nesting, and whether a selection change was held back
+    int m_updateDepth;
+    bool m_selectionPending;
+
+    // Categories indexed by level 1 index
+    QVector<Category> m_categories;
+
+    // View-side state of the items that have any, by ContentKey, so it
+    // stays with its item when tabs are removed or moved. Mutable because
+    // getContentWidget() builds lazy entries on demand
+    mutable QHash<ContentKey, ContentEntry> m_contentEntries;
+
+    mutable ContentLru m_contentLru;
+    mutable qint64 m_builtContentBytes;
+
+    // State saved by the state hook for evicted widgets
+    mutable QHash<ContentKey, QVariant> m_savedStates;
+
+    // Content budget (0 = unlimited) and eviction hooks
+    int m_maxContentWidgets;
+    qint64 m_maxContentBytes;
+    ContentSizeEstimator m_sizeEstimator;
+    ContentStateSaver m_stateSaver;
+    ContentStateRestorer m_stateRestorer;
+
+    // Content widget recycling: how each content type is built and bound,
+    // its pool (least recently bound first) and the item each pooled
+    // widget is bound to
+    struct ContentType {
+        ContentFactory create;
+        ContentBinder bind;
+    };
+    int m_recyclingPoolSize;
+    QHash<QString, ContentType> m_contentTypes;
+    mutable QHash<QString, QList<CustomWidget*> > m_contentPools;
+    mutable QHash<CustomWidget*, ContentKey> m_recycledKeys;
+
+    // Defers eviction until the current selection has been displayed
+    QTimer *m_trimTimer;
 
-    // Map to store content widgets for each level 2 tab
-    // Key: level2TabBar, Value: Map of (tab index -> widget)
-    QMap<QTabBar*, QMap<int, CustomWidget*>> m_contentWidgets;
+    // Selection coalescing: the last selection not emitted yet, and how
+    // many were dropped in favor of a later one
+    QTimer *m_selectionTimer;
+    int m_pendingLevel1Index;
+    int m_pendingLevel2Index;
+    int m_skippedSelections;
 };
 
 #endif // MENUWIDGET_H
@@ -0,0 +1,155 @@
+#include "MirrorWidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QChildEvent>
+#include <QTimer>
+
+namespace {
+
+// Minimum time between two refreshes, one frame at 60 Hz
+const int FrameInterval = 16;
+
+}
+
+MirrorWidget::MirrorWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_grabbing(false)
+{
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(FrameInterval);
+    connect(m_refreshTimer, &QTimer::timeout, this, &MirrorWidget::refresh);
+}
+
+MirrorWidget::~MirrorWidget()
+{
+    if (m_source) {
+        unwatch(m_source);
+    }
+}
+
+void MirrorWidget::setSource(QWidget *source)
+{
+    if (source == m_source) {
+        return;
+    }
+
+    if (m_source) {
+        unwatch(m_source);
+    }
+
+    m_source = source;
+    m_pixmap = QPixmap();
+
+    if (m_source) {
+        watch(m_source);
+        scheduleRefresh();
+    }
+
+    update();
+}
+
+QWidget *MirrorWidget::source() const
+{
+    return m_source;
+}
+
+QSize MirrorWidget::sizeHint() const
+{
+    return m_source ? m_source->sizeHint() : QWidget::sizeHint();
+}
+
+void MirrorWidget::watch(QWidget *widget)
+{
+    // Children paint on their own, so they are watched too
+    widget->installEventFilter(this);
+
+    const QList<QWidget*> children = widget->findChildren<QWidget*>();
+    for (QWidget *child : children) {
+        child->installEventFilter(this);
+    }
+}
+
+void MirrorWidget::unwatch(QWidget *widget)
+{
+    widget->removeEventFilter(this);
+
+    const QList<QWidget*> children = widget->findChildren<QWidget*>();
+    for (QWidget *child : children) {
+        child->removeEventFilter(this);
+    }
+}
+
+void MirrorWidget::scheduleRefresh()
+{
+    // A pending refresh already covers this change
+    if (!m_refreshTimer->isActive()) {
+        m_refreshTimer->start();
+    }
+}
+
+bool MirrorWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::ChildAdded: {
+        QObject *child = static_cast<QChildEvent*>(event)->child();
+        if (child->isWidgetType()) {
+            watch(static_cast<QWidget*>(child));
+        }
+        break;
+    }
+    case QEvent::Paint:
+    case QEvent::Resize:
+        // Rendering the source for the cache paints it too; not a change
+        if (!m_grabbing) {
+            scheduleRefresh();
+        }
+        break;
+    default:
+        break;
+    }
+
+    return QWidget::eventFilter(watched, event);
+}
+
+void MirrorWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    // Changes while hidden were not picked up
+    if (m_source) {
+        scheduleRefresh();
+    }
+}
+
+void MirrorWidget::refresh()
+{
+    if (!m_source || !isVisible()) {
+        return;
+    }
+
+    m_grabbing = true;
+    m_pixmap = m_source->grab();
+    m_grabbing = false;
+
+    update();
+}
+
+void MirrorWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().window());
+
+    if (m_pixmap.isNull()) {
+        return;
+    }
+
+    // Scale to fit, keeping the aspect ratio, centered
+    QSize size = m_pixmap.size() / m_pixmap.devicePixelRatio();
+    size.scale(this->size(), Qt::KeepAspectRatio);
+    QRect target(QPoint((width() - size.width()) / 2, (height() - size.height()) / 2), size);
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawPixmap(target, m_pixmap);
+}
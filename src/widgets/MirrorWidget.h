@@ -0,0 +1,51 @@
+#ifndef MIRRORWIDGET_H
+#define MIRRORWIDGET_H
+
+#include <QWidget>
+#include <QPointer>
+#include <QPixmap>
+
+class QTimer;
+
+// Shows a cached rendering of another widget, scaled to fit, so the same
+// content can appear in a second place without a second instance. The
+// cache is refreshed when the source (or one of its children) repaints
+// or resizes, at most once per frame and only while the mirror is shown.
+class MirrorWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MirrorWidget(QWidget *parent = nullptr);
+    ~MirrorWidget();
+
+    // Widget to mirror, nullptr to stop mirroring
+    void setSource(QWidget *source);
+    QWidget *source() const;
+
+    QSize sizeHint() const override;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    void watch(QWidget *widget);
+    void unwatch(QWidget *widget);
+    void scheduleRefresh();
+
+    QPointer<QWidget> m_source;
+    QPixmap m_pixmap;
+
+    // Coalesces repaints of the source into one refresh per frame
+    QTimer *m_refreshTimer;
+
+    // Set while grabbing, the source's own paint events are ours then
+    bool m_grabbing;
+};
+
+#endif // MIRRORWIDGET_H
@@ -0,0 +1,171 @@
+#include "NavigationRecorder.h"
+#include "MenuWidget.h"
+#include "MainWidget.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+
+NavigationRecorder::NavigationRecorder(QObject *parent)
+    : QObject(parent)
+    , m_recording(false)
+{
+}
+
+NavigationRecorder::~NavigationRecorder()
+{
+}
+
+void NavigationRecorder::setMenuWidget(MenuWidget *menuWidget)
+{
+    if (m_menuWidget) {
+        disconnect(m_menuWidget, nullptr, this, nullptr);
+    }
+
+    m_menuWidget = menuWidget;
+
+    if (m_menuWidget) {
+        connect(m_menuWidget, &MenuWidget::tabSelectionChanged,
+                this, &NavigationRecorder::onTabSelectionChanged);
+    }
+}
+
+void NavigationRecorder::setMainWidget(MainWidget *mainWidget)
+{
+    if (m_mainWidget) {
+        disconnect(m_mainWidget, nullptr, this, nullptr);
+    }
+
+    m_mainWidget = mainWidget;
+
+    if (m_mainWidget) {
+        connect(m_mainWidget, &MainWidget::currentAreaChanged,
+                this, &NavigationRecorder::onCurrentAreaChanged);
+    }
+}
+
+void NavigationRecorder::start()
+{
+    m_clock.start();
+    m_recording = true;
+}
+
+void NavigationRecorder::stop()
+{
+    m_recording = false;
+}
+
+bool NavigationRecorder::isRecording() const
+{
+    return m_recording;
+}
+
+const QVector<NavigationRecorder::Event> &NavigationRecorder::events() const
+{
+    return m_events;
+}
+
+void NavigationRecorder::clear()
+{
+    m_events.clear();
+}
+
+bool NavigationRecorder::save(const QString &fileName, QString *errorString) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "# navigation log: <msec> select <level1> <level2> | <msec> area <index>\n";
+    for (const Event &event : m_events) {
+        if (event.type == Event::Selection) {
+            out << event.time << " select " << event.first << ' ' << event.second << '\n';
+        } else {
+            out << event.time << " area " << event.first << '\n';
+        }
+    }
+    out.flush();
+
+    if (!file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool NavigationRecorder::load(const QString &fileName, QVector<Event> *events, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+
+    QVector<Event> loaded;
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+
+        QStringList fields = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        bool ok = fields.size() >= 3;
+        Event event;
+        if (ok) {
+            event.time = fields.at(0).toLongLong(&ok);
+        }
+        if (ok && fields.at(1) == QLatin1String("select") && fields.size() == 4) {
+            bool secondOk = false;
+            event.type = Event::Selection;
+            event.first = fields.at(2).toInt(&ok);
+            event.second = fields.at(3).toInt(&secondOk);
+            ok = ok && secondOk;
+        } else if (ok && fields.at(1) == QLatin1String("area") && fields.size() == 3) {
+            event.type = Event::AreaSwitch;
+            event.first = fields.at(2).toInt(&ok);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            if (errorString) {
+                *errorString = QString("line %1: cannot parse \"%2\"").arg(lineNumber).arg(line);
+            }
+            return false;
+        }
+        loaded.append(event);
+    }
+
+    *events = loaded;
+    return true;
+}
+
+void NavigationRecorder::onTabSelectionChanged(int level1Index, int level2Index)
+{
+    append(Event::Selection, level1Index, level2Index);
+}
+
+void NavigationRecorder::onCurrentAreaChanged(int areaIndex)
+{
+    append(Event::AreaSwitch, areaIndex);
+}
+
+void NavigationRecorder::append(Event::Type type, int first, int second)
+{
+    if (!m_recording) {
+        return;
+    }
+    m_events.append(Event(m_clock.elapsed(), type, first, second));
+}
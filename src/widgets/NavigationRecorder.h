@@ -0,0 +1,70 @@
+#ifndef NAVIGATIONRECORDER_H
+#define NAVIGATIONRECORDER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QVector>
+
+class MenuWidget;
+class MainWidget;
+
+// Logs the tab selections of a MenuWidget and the area switches of a
+// MainWidget with their time, so an operator's navigation can be
+// replayed later (see tools/navreplay). Logs are text, one event per line:
+//
+//   <msec> select <level1> <level2>
+//   <msec> area <areaIndex>
+//
+// Lines starting with '#' are comments.
+class NavigationRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Event {
+        enum Type { Selection, AreaSwitch };
+
+        Event() : time(0), type(Selection), first(-1), second(-1) {}
+        Event(qint64 time, Type type, int first, int second = -1)
+            : time(time), type(type), first(first), second(second) {}
+
+        qint64 time;    // Milliseconds since recording started
+        Type type;
+        int first;      // Level 1 index, or the area index
+        int second;     // Level 2 index, unused for area switches
+    };
+
+    explicit NavigationRecorder(QObject *parent = nullptr);
+    ~NavigationRecorder();
+
+    void setMenuWidget(MenuWidget *menuWidget);
+    void setMainWidget(MainWidget *mainWidget);
+
+    // Recording restarts the clock, events are appended to the log
+    void start();
+    void stop();
+    bool isRecording() const;
+
+    const QVector<Event> &events() const;
+    void clear();
+
+    bool save(const QString &fileName, QString *errorString = nullptr) const;
+    static bool load(const QString &fileName, QVector<Event> *events, QString *errorString = nullptr);
+
+private slots:
+    void onTabSelectionChanged(int level1Index, int level2Index);
+    void onCurrentAreaChanged(int areaIndex);
+
+private:
+    void append(Event::Type type, int first, int second = -1);
+
+    QPointer<MenuWidget> m_menuWidget;
+    QPointer<MainWidget> m_mainWidget;
+
+    QElapsedTimer m_clock;
+    bool m_recording;
+    QVector<Event> m_events;
+};
+
+#endif // NAVIGATIONRECORDER_H
@@ -0,0 +1,129 @@
+#include "SearchPalette.h"
+#include "MenuWidget.h"
+#include "../model/SearchIndex.h"
+
+#include <QKeyEvent>
+
+namespace {
+
+// Matches listed for a query
+const int MaxResults = 20;
+
+// Item data roles holding the tab indices of a match
+const int Level1IndexRole = Qt::UserRole;
+const int Level2IndexRole = Qt::UserRole + 1;
+
+const int PaletteWidth = 480;
+
+}
+
+SearchPalette::SearchPalette(MenuWidget *menuWidget, QWidget *parent)
+    : QFrame(parent, Qt::Popup)
+    , m_menuWidget(menuWidget)
+{
+    setFrameShape(QFrame::StyledPanel);
+
+    m_layout = new QVBoxLayout(this);
+
+    m_queryEdit = new QLineEdit(this);
+    m_queryEdit->setPlaceholderText(tr("Go to tab..."));
+    m_queryEdit->setClearButtonEnabled(true);
+
+    m_resultList = new QListWidget(this);
+    m_resultList->setUniformItemSizes(true);
+
+    m_layout->addWidget(m_queryEdit);
+    m_layout->addWidget(m_resultList);
+
+    setLayout(m_layout);
+
+    // Arrow keys move through the results while the query keeps focus
+    m_queryEdit->installEventFilter(this);
+
+    connect(m_queryEdit, &QLineEdit::textChanged, this, &SearchPalette::onQueryChanged);
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, &SearchPalette::activateCurrent);
+    connect(m_resultList, &QListWidget::itemActivated, this, &SearchPalette::activateCurrent);
+    connect(m_resultList, &QListWidget::itemClicked, this, &SearchPalette::activateCurrent);
+}
+
+SearchPalette::~SearchPalette()
+{
+}
+
+void SearchPalette::popup()
+{
+    m_queryEdit->clear();
+    m_resultList->clear();
+
+    QWidget *window = parentWidget() ? parentWidget()->window() : nullptr;
+    if (window) {
+        int width = qMin(PaletteWidth, window->width());
+        QPoint topLeft = window->mapToGlobal(QPoint((window->width() - width) / 2, 0));
+        setGeometry(QRect(topLeft, QSize(width, sizeHint().height())));
+    }
+
+    show();
+    m_queryEdit->setFocus();
+}
+
+bool SearchPalette::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_queryEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent*>(event);
+        int row = m_resultList->currentRow();
+
+        if (keyEvent->key() == Qt::Key_Down && row + 1 < m_resultList->count()) {
+            m_resultList->setCurrentRow(row + 1);
+            return true;
+        }
+        if (keyEvent->key() == Qt::Key_Up && row > 0) {
+            m_resultList->setCurrentRow(row - 1);
+            return true;
+        }
+    }
+
+    return QFrame::eventFilter(watched, event);
+}
+
+void SearchPalette::onQueryChanged(const QString &text)
+{
+    m_resultList->clear();
+
+    QAbstractItemModel *model = m_menuWidget->model();
+    if (!model) {
+        return;
+    }
+
+    const QVector<SearchIndex::Match> matches = m_menuWidget->searchIndex()->search(text, MaxResults);
+    for (const SearchIndex::Match &match : matches) {
+        // Items are shown with their category, which disambiguates them
+        QString text = match.label;
+        if (match.item >= 0) {
+            QString category = model->index(match.category, 0).data(Qt::DisplayRole).toString();
+            text = tr("%1  (%2)").arg(match.label, category);
+        }
+
+        QListWidgetItem *item = new QListWidgetItem(text);
+        item->setData(Level1IndexRole, match.category);
+        item->setData(Level2IndexRole, match.item);
+        m_resultList->addItem(item);
+    }
+
+    if (m_resultList->count() > 0) {
+        m_resultList->setCurrentRow(0);
+    }
+}
+
+void SearchPalette::activateCurrent()
+{
+    QListWidgetItem *item = m_resultList->currentItem();
+    if (!item) {
+        return;
+    }
+
+    int level1Index = item->data(Level1IndexRole).toInt();
+    int level2Index = item->data(Level2IndexRole).toInt();
+
+    hide();
+    m_menuWidget->activateTabs(level1Index, level2Index);
+}
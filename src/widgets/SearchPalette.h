@@ -0,0 +1,38 @@
+#ifndef SEARCHPALETTE_H
+#define SEARCHPALETTE_H
+
+#include <QFrame>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+class MenuWidget;
+
+// Type-ahead popup over all tab labels of a MenuWidget. Typing lists the
+// best matches; Enter or a click jumps to the selected tab.
+class SearchPalette : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit SearchPalette(MenuWidget *menuWidget, QWidget *parent = nullptr);
+    ~SearchPalette();
+
+    // Show at the top of the parent window with an empty query
+    void popup();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onQueryChanged(const QString &text);
+    void activateCurrent();
+
+private:
+    MenuWidget *m_menuWidget;
+    QVBoxLayout *m_layout;
+    QLineEdit *m_queryEdit;
+    QListWidget *m_resultList;
+};
+
+#endif // SEARCHPALETTE_H
@@ -0,0 +1,625 @@
+#include "TabStrip.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QToolButton>
+#include <algorithm>
+
+namespace {
+
+// Tab geometry, in pixels
+const int TabHorizontalPadding = 12;
+const int TabVerticalPadding = 6;
+const int MinimumTabWidth = 40;
+const int MaximumTabWidth = 240;
+const int ScrollButtonWidth = 20;
+
+// Rendered labels kept around; a viewport shows far fewer than this
+const int MaxCachedLabels = 512;
+
+}
+
+TabStrip::TabStrip(QWidget *parent)
+    : QWidget(parent)
+    , m_hasRoot(false)
+    , m_currentIndex(-1)
+    , m_scrollOffset(0)
+    , m_laidOut(0)
+{
+    setFocusPolicy(Qt::TabFocus);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+
+    // Same role as QTabBar's scroll arrows when the tabs overflow
+    m_scrollLeftButton = new QToolButton(this);
+    m_scrollLeftButton->setArrowType(Qt::LeftArrow);
+    m_scrollLeftButton->setAutoRepeat(true);
+    m_scrollLeftButton->hide();
+
+    m_scrollRightButton = new QToolButton(this);
+    m_scrollRightButton->setArrowType(Qt::RightArrow);
+    m_scrollRightButton->setAutoRepeat(true);
+    m_scrollRightButton->hide();
+
+    connect(m_scrollLeftButton, &QToolButton::clicked, this, [this]() {
+        setScrollOffset(m_scrollOffset - viewportRect().width() / 2);
+    });
+    connect(m_scrollRightButton, &QToolButton::clicked, this, [this]() {
+        setScrollOffset(m_scrollOffset + viewportRect().width() / 2);
+    });
+}
+
+TabStrip::~TabStrip()
+{
+    // A shared model outlives us, stop listening before members go away
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+}
+
+void TabStrip::setModel(QAbstractItemModel *model, const QModelIndex &rootIndex)
+{
+    if (m_model != model) {
+        if (m_model) {
+            disconnect(m_model, nullptr, this, nullptr);
+        }
+
+        m_model = model;
+
+        if (m_model) {
+            connect(m_model.data(), &QAbstractItemModel::rowsInserted,
+                    this, &TabStrip::onRowsInserted);
+            connect(m_model.data(), &QAbstractItemModel::rowsRemoved,
+                    this, &TabStrip::onRowsRemoved);
+            connect(m_model.data(), &QAbstractItemModel::dataChanged,
+                    this, &TabStrip::onDataChanged);
+            connect(m_model.data(), &QAbstractItemModel::rowsMoved,
+                    this, &TabStrip::onRowsMoved);
+            connect(m_model.data(), &QAbstractItemModel::layoutChanged,
+                    this, &TabStrip::resetTabs);
+            connect(m_model.data(), &QAbstractItemModel::modelReset,
+                    this, &TabStrip::resetTabs);
+        }
+    }
+
+    m_rootIndex = rootIndex;
+    m_hasRoot = rootIndex.isValid();
+    m_currentIndex = -1;
+    m_scrollOffset = 0;
+    resetTabs();
+}
+
+QAbstractItemModel *TabStrip::model() const
+{
+    return m_model;
+}
+
+QModelIndex TabStrip::rootIndex() const
+{
+    return m_rootIndex;
+}
+
+int TabStrip::count() const
+{
+    return m_tabWidths.size();
+}
+
+int TabStrip::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+void TabStrip::setCurrentIndex(int index)
+{
+    if (index < 0 || index >= count() || index == m_currentIndex) {
+        return;
+    }
+
+    update(tabRect(m_currentIndex));
+    m_currentIndex = index;
+    update(tabRect(m_currentIndex));
+
+    ensureTabVisible(index);
+    emit currentChanged(index);
+}
+
+QString TabStrip::tabText(int index) const
+{
+    if (!m_model || index < 0 || index >= count()) {
+        return QString();
+    }
+
+    return m_model->index(index, 0, m_rootIndex).data(Qt::DisplayRole).toString();
+}
+
+QRect TabStrip::tabRect(int index) const
+{
+    if (index < 0 || index >= count()) {
+        return QRect();
+    }
+
+    layoutTabs(index);
+    return QRect(m_tabOffsets.at(index) - m_scrollOffset, 0, m_tabWidths.at(index), height());
+}
+
+int TabStrip::tabAt(const QPoint &pos) const
+{
+    if (!viewportRect().contains(pos)) {
+        return -1;
+    }
+
+    // Last tab starting at or before x
+    int x = pos.x() + m_scrollOffset;
+    layoutTabs(count() - 1, x);
+
+    int index = int(std::upper_bound(m_tabOffsets.constBegin(),
+                                     m_tabOffsets.constBegin() + m_laidOut + 1, x)
+                    - m_tabOffsets.constBegin()) - 1;
+
+    return index >= 0 && index < m_laidOut ? index : -1;
+}
+
+int TabStrip::scrollOffset() const
+{
+    return m_scrollOffset;
+}
+
+void TabStrip::setScrollOffset(int offset)
+{
+    // Only a strip laid out to its end can run out of tabs in the viewport
+    int viewportWidth = viewportRect().width();
+    layoutTabs(count() - 1, offset + viewportWidth);
+
+    if (m_laidOut == count()) {
+        offset = qMin(offset, laidOutWidth() - viewportWidth);
+    }
+    offset = qMax(0, offset);
+
+    if (offset != m_scrollOffset) {
+        m_scrollOffset = offset;
+        update();
+    }
+
+    updateScrollButtons();
+}
+
+void TabStrip::ensureTabVisible(int index)
+{
+    if (index < 0 || index >= count()) {
+        return;
+    }
+
+    layoutTabs(index);
+
+    int left = m_tabOffsets.at(index);
+    int right = m_tabOffsets.at(index + 1);
+    int viewportWidth = viewportRect().width();
+
+    if (left < m_scrollOffset) {
+        setScrollOffset(left);
+    } else if (right > m_scrollOffset + viewportWidth) {
+        setScrollOffset(right - viewportWidth);
+    }
+}
+
+QSize TabStrip::sizeHint() const
+{
+    // Capped so that a huge category does not widen the window
+    const int maxWidth = MaximumTabWidth * 4;
+    layoutTabs(count() - 1, maxWidth);
+
+    int width = qMin(laidOutWidth(), maxWidth);
+    return QSize(qMax(width, minimumSizeHint().width()), minimumSizeHint().height());
+}
+
+QSize TabStrip::minimumSizeHint() const
+{
+    return QSize(2 * ScrollButtonWidth + MinimumTabWidth,
+                 fontMetrics().height() + 2 * TabVerticalPadding);
+}
+
+void TabStrip::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    QRect viewport = viewportRect();
+    QRect dirty = event->rect() & viewport;
+
+    painter.fillRect(dirty, palette().window());
+
+    if (count() == 0 || dirty.isEmpty()) {
+        return;
+    }
+
+    painter.setClipRect(dirty);
+
+    // Only the tabs intersecting the dirty part of the viewport are laid
+    // out and visited
+    int left = dirty.left() + m_scrollOffset;
+    int right = dirty.right() + m_scrollOffset;
+    layoutTabs(count() - 1, right);
+
+    int first = int(std::upper_bound(m_tabOffsets.constBegin(),
+                                     m_tabOffsets.constBegin() + m_laidOut + 1, left)
+                    - m_tabOffsets.constBegin()) - 1;
+
+    for (int index = qMax(0, first); index < m_laidOut && m_tabOffsets.at(index) <= right; ++index) {
+        QRect rect(m_tabOffsets.at(index) - m_scrollOffset, 0, m_tabWidths.at(index), height());
+
+        if (index == m_currentIndex) {
+            painter.fillRect(rect, palette().base());
+            painter.fillRect(QRect(rect.left(), rect.bottom() - 1, rect.width(), 2),
+                             palette().highlight());
+        } else {
+            painter.fillRect(rect, palette().button());
+        }
+
+        painter.setPen(palette().color(QPalette::Mid));
+        painter.drawLine(rect.topRight(), rect.bottomRight());
+
+        QPixmap label = labelPixmap(index);
+        QSize labelSize = label.size() / label.devicePixelRatio();
+        QPoint labelPos(rect.left() + (rect.width() - labelSize.width()) / 2,
+                        rect.top() + (rect.height() - labelSize.height()) / 2);
+        painter.drawPixmap(labelPos, label);
+    }
+}
+
+void TabStrip::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    m_scrollLeftButton->setGeometry(width() - 2 * ScrollButtonWidth, 0, ScrollButtonWidth, height());
+    m_scrollRightButton->setGeometry(width() - ScrollButtonWidth, 0, ScrollButtonWidth, height());
+
+    // Clamp the offset to the new viewport and refresh the arrows
+    setScrollOffset(m_scrollOffset);
+}
+
+void TabStrip::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    int index = tabAt(event->pos());
+    if (index >= 0) {
+        setCurrentIndex(index);
+    }
+}
+
+void TabStrip::wheelEvent(QWheelEvent *event)
+{
+    // Vertical wheels scroll horizontally too
+    QPoint delta = event->angleDelta();
+    int steps = delta.x() != 0 ? delta.x() : delta.y();
+
+    setScrollOffset(m_scrollOffset - steps);
+    event->accept();
+}
+
+void TabStrip::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Left:
+        setCurrentIndex(m_currentIndex - 1);
+        break;
+    case Qt::Key_Right:
+        setCurrentIndex(m_currentIndex + 1);
+        break;
+    case Qt::Key_Home:
+        setCurrentIndex(0);
+        break;
+    case Qt::Key_End:
+        setCurrentIndex(count() - 1);
+        break;
+    default:
+        QWidget::keyPressEvent(event);
+        return;
+    }
+
+    event->accept();
+}
+
+void TabStrip::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+
+    // Cached metrics and labels depend on font and colors
+    switch (event->type()) {
+    case QEvent::FontChange:
+    case QEvent::StyleChange:
+        m_tabWidths.fill(-1);
+        m_labelPixmaps.clear();
+        invalidateLayout(0);
+        updateGeometry();
+        break;
+    case QEvent::PaletteChange:
+        m_labelPixmaps.clear();
+        update();
+        break;
+    default:
+        break;
+    }
+}
+
+void TabStrip::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (m_rootIndex != parent) {
+        return;
+    }
+
+    int inserted = last - first + 1;
+    m_tabWidths.insert(first, inserted, -1);
+    invalidateLayout(first);
+
+    // Cached labels are keyed by row
+    if (first < count() - inserted) {
+        m_labelPixmaps.clear();
+    }
+
+    if (m_currentIndex >= first) {
+        m_currentIndex += inserted;
+    }
+
+    updateGeometry();
+
+    // Like QTabBar, the first tab becomes current
+    if (m_currentIndex < 0) {
+        setCurrentIndex(0);
+    }
+}
+
+void TabStrip::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (m_rootIndex != parent) {
+        return;
+    }
+
+    first = qBound(0, first, count());
+    last = qBound(first - 1, last, count() - 1);
+
+    m_tabWidths.remove(first, last - first + 1);
+    invalidateLayout(first);
+    m_labelPixmaps.clear();
+    updateGeometry();
+
+    if (m_currentIndex > last) {
+        m_currentIndex -= last - first + 1;
+    } else if (m_currentIndex >= first) {
+        // The current tab went away, select its neighbour
+        m_currentIndex = -1;
+        if (count() > 0) {
+            setCurrentIndex(qMin(first, count() - 1));
+        } else {
+            emit currentChanged(-1);
+        }
+    }
+
+    setScrollOffset(m_scrollOffset);
+}
+
+void TabStrip::onRowsMoved(const QModelIndex &parent, int start, int end,
+                           const QModelIndex &destination, int row)
+{
+    bool fromRoot = m_rootIndex == parent;
+    bool toRoot = m_rootIndex == destination;
+    if (!fromRoot && !toRoot) {
+        return;
+    }
+
+    // Tabs arriving from or leaving for another parent
+    if (!fromRoot || !toRoot) {
+        resetTabs();
+        return;
+    }
+
+    start = qBound(0, start, count());
+    end = qBound(start - 1, end, count() - 1);
+    int moved = end - start + 1;
+    if (moved <= 0) {
+        return;
+    }
+
+    // row counts the moved tabs themselves
+    int to = row > start ? row - moved : row;
+
+    // Measured widths travel with their tabs
+    QVector<int> widths = m_tabWidths.mid(start, moved);
+    m_tabWidths.remove(start, moved);
+    for (int i = 0; i < moved; ++i) {
+        m_tabWidths.insert(to + i, widths.at(i));
+    }
+    invalidateLayout(qMin(start, to));
+    m_labelPixmaps.clear();
+
+    // The current tab stays current, at its new index, without a signal
+    if (m_currentIndex >= start && m_currentIndex <= end) {
+        m_currentIndex = to + m_currentIndex - start;
+    } else if (m_currentIndex >= 0) {
+        int rest = m_currentIndex < start ? m_currentIndex : m_currentIndex - moved;
+        m_currentIndex = rest < to ? rest : rest + moved;
+    }
+
+    update();
+    setScrollOffset(m_scrollOffset);
+}
+
+void TabStrip::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QVector<int> &roles)
+{
+    if (!topLeft.isValid() || m_rootIndex != topLeft.parent()) {
+        return;
+    }
+
+    // Only labels are displayed
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole)) {
+        return;
+    }
+
+    QFontMetrics metrics = fontMetrics();
+    int first = qMax(0, topLeft.row());
+    int last = qMin(bottomRight.row(), count() - 1);
+    int shiftFrom = -1;
+
+    for (int row = first; row <= last; ++row) {
+        m_labelPixmaps.remove(row);
+
+        // Labels not measured yet are picked up when they are laid out
+        if (m_tabWidths.at(row) < 0) {
+            continue;
+        }
+
+        // A label of the same width only needs its own rect repainted
+        int width = measureTab(row, metrics);
+        if (width != m_tabWidths.at(row)) {
+            m_tabWidths[row] = width;
+            if (shiftFrom < 0) {
+                shiftFrom = row;
+            }
+        } else if (row < m_laidOut) {
+            update(tabRect(row));
+        }
+    }
+
+    // A wider or narrower label moves every tab after it
+    if (shiftFrom >= 0) {
+        invalidateLayout(shiftFrom);
+        updateGeometry();
+        setScrollOffset(m_scrollOffset);
+    }
+}
+
+void TabStrip::resetTabs()
+{
+    // A root removed from the model leaves no tabs, not the top-level rows
+    int rows = 0;
+    if (m_model && m_rootIndex.isValid() == m_hasRoot) {
+        rows = m_model->rowCount(m_rootIndex);
+    }
+
+    m_tabWidths.fill(-1, rows);
+    m_labelPixmaps.clear();
+    invalidateLayout(0);
+    updateGeometry();
+
+    // Structure changed wholesale: keep the position, no signal
+    m_currentIndex = rows > 0 ? qBound(0, m_currentIndex, rows - 1) : -1;
+    setScrollOffset(m_scrollOffset);
+}
+
+void TabStrip::layoutTabs(int lastIndex, int untilX) const
+{
+    m_tabOffsets.resize(count() + 1);
+    m_tabOffsets[0] = 0;
+
+    // Labels are measured once, then only prefix sums are redone, and
+    // only as far as the caller needs
+    lastIndex = qMin(lastIndex, count() - 1);
+    if (m_laidOut > lastIndex || m_tabOffsets.at(m_laidOut) > untilX) {
+        return;
+    }
+
+    QFontMetrics metrics = fontMetrics();
+
+    while (m_laidOut <= lastIndex && m_tabOffsets.at(m_laidOut) <= untilX) {
+        int index = m_laidOut;
+        if (m_tabWidths.at(index) < 0) {
+            m_tabWidths[index] = measureTab(index, metrics);
+        }
+        m_tabOffsets[index + 1] = m_tabOffsets.at(index) + m_tabWidths.at(index);
+        ++m_laidOut;
+    }
+}
+
+void TabStrip::invalidateLayout(int from)
+{
+    from = qBound(0, from, m_laidOut);
+
+    // Tabs before 'from' keep their place, only the rest of the viewport
+    // is repainted
+    if (from < m_tabOffsets.size()) {
+        QRect dirty = viewportRect();
+        dirty.setLeft(qMax(dirty.left(), m_tabOffsets.at(from) - m_scrollOffset));
+        update(dirty);
+    } else {
+        update();
+    }
+
+    m_laidOut = from;
+}
+
+int TabStrip::measureTab(int index, const QFontMetrics &metrics) const
+{
+    int width = metrics.horizontalAdvance(tabText(index)) + 2 * TabHorizontalPadding;
+    return qBound(MinimumTabWidth, width, MaximumTabWidth);
+}
+
+int TabStrip::laidOutWidth() const
+{
+    return m_tabOffsets.at(m_laidOut);
+}
+
+QRect TabStrip::viewportRect() const
+{
+    // The scroll arrows take the right end when the tabs overflow
+    if (m_scrollLeftButton->isVisibleTo(this)) {
+        return QRect(0, 0, qMax(0, width() - 2 * ScrollButtonWidth), height());
+    }
+
+    return rect();
+}
+
+QPixmap TabStrip::labelPixmap(int index) const
+{
+    QHash<int, QPixmap>::const_iterator it = m_labelPixmaps.constFind(index);
+    if (it != m_labelPixmaps.constEnd()) {
+        return it.value();
+    }
+
+    QSize size(m_tabWidths.at(index) - 2 * TabHorizontalPadding, fontMetrics().height());
+    QString text = fontMetrics().elidedText(tabText(index), Qt::ElideRight, size.width());
+
+    // Rendered at device resolution so it stays sharp on high-DPI screens
+    qreal ratio = devicePixelRatioF();
+    QPixmap pixmap(size * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setFont(font());
+    painter.setPen(palette().color(QPalette::ButtonText));
+    painter.drawText(QRect(QPoint(0, 0), size), Qt::AlignCenter, text);
+    painter.end();
+
+    if (m_labelPixmaps.size() >= MaxCachedLabels) {
+        m_labelPixmaps.clear();
+    }
+    m_labelPixmaps.insert(index, pixmap);
+
+    return pixmap;
+}
+
+void TabStrip::updateScrollButtons()
+{
+    layoutTabs(count() - 1, width());
+    bool overflow = laidOutWidth() > width();
+
+    if (overflow != m_scrollLeftButton->isVisibleTo(this)) {
+        m_scrollLeftButton->setVisible(overflow);
+        m_scrollRightButton->setVisible(overflow);
+
+        // The viewport changed size, clamp again
+        setScrollOffset(m_scrollOffset);
+        update();
+        return;
+    }
+
+    int viewportEnd = m_scrollOffset + viewportRect().width();
+    layoutTabs(count() - 1, viewportEnd);
+
+    m_scrollLeftButton->setEnabled(m_scrollOffset > 0);
+    m_scrollRightButton->setEnabled(laidOutWidth() > viewportEnd);
+}
@@ -0,0 +1,101 @@
+#ifndef TABSTRIP_H
+#define TABSTRIP_H
+
+#include <QWidget>
+#include <QAbstractItemModel>
+#include <QPersistentModelIndex>
+#include <QPointer>
+#include <QVector>
+#include <QHash>
+#include <QPixmap>
+#include <QFontMetrics>
+#include <climits>
+
+class QToolButton;
+
+// Horizontal tab strip showing the children of one model index.
+// Only the tabs inside the viewport are painted; label widths and
+// rendered labels are cached, so it scales to tens of thousands of tabs.
+class TabStrip : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TabStrip(QWidget *parent = nullptr);
+    ~TabStrip();
+
+    // Show the children of rootIndex as tabs (does not emit currentChanged)
+    void setModel(QAbstractItemModel *model, const QModelIndex &rootIndex = QModelIndex());
+    QAbstractItemModel *model() const;
+    QModelIndex rootIndex() const;
+
+    // QTabBar-like API
+    int count() const;
+    int currentIndex() const;
+    void setCurrentIndex(int index);
+    QString tabText(int index) const;
+    QRect tabRect(int index) const;
+    int tabAt(const QPoint &pos) const;
+
+    // Horizontal scroll position in pixels
+    int scrollOffset() const;
+    void setScrollOffset(int offset);
+
+    // Scroll so that the tab is fully visible
+    void ensureTabVisible(int index);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+signals:
+    // Emitted when the current tab changes
+    void currentChanged(int index);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private slots:
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsMoved(const QModelIndex &parent, int start, int end,
+                     const QModelIndex &destination, int row);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                       const QVector<int> &roles);
+    void resetTabs();
+
+private:
+    // Lay out tabs up to lastIndex, stopping early once untilX is covered
+    void layoutTabs(int lastIndex, int untilX = INT_MAX) const;
+    void invalidateLayout(int from);
+    int measureTab(int index, const QFontMetrics &metrics) const;
+    int laidOutWidth() const;
+    QRect viewportRect() const;
+    QPixmap labelPixmap(int index) const;
+    void updateScrollButtons();
+
+    QPointer<QAbstractItemModel> m_model;
+    QPersistentModelIndex m_rootIndex;
+    bool m_hasRoot;
+    int m_currentIndex;
+    int m_scrollOffset;
+
+    // Label widths (-1 = not measured yet) and their prefix sums; only
+    // the offsets of the first m_laidOut tabs (and the end of the last
+    // one) are valid, the rest is laid out on demand
+    mutable QVector<int> m_tabWidths;
+    mutable QVector<int> m_tabOffsets;
+    mutable int m_laidOut;
+
+    // Rendered labels of recently painted tabs
+    mutable QHash<int, QPixmap> m_labelPixmaps;
+
+    QToolButton *m_scrollLeftButton;
+    QToolButton *m_scrollRightButton;
+};
+
+#endif // TABSTRIP_H
@@ -4,6 +4,12 @@
 #include "src/widgets/MenuWidget.h"
 #include "src/widgets/CustomWidget.h"
 
+// Build the CustomWidget only when its tab is first displayed
+static MenuWidget::ContentFactory lazyContent(const QString &text)
+{
+    return [text]() { return new CustomWidget(text); };
+}
+
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
@@ -31,26 +37,26 @@ int main(int argc, char *argv[])
     menuWidget->addLevel1Tab("Sports");
 
     // Add Level 2 tabs for Electronics (index 0)
-    menuWidget->addLevel2Tab(0, "Smartphones", new CustomWidget("📱 Smartphones Content\n\nLatest models available:\n- iPhone 15 Pro\n- Samsung Galaxy S24\n- Google Pixel 8"));
-    menuWidget->addLevel2Tab(0, "Laptops", new CustomWidget("💻 Laptops Content\n\nTop picks:\n- MacBook Pro M3\n- Dell XPS 15\n- ThinkPad X1 Carbon"));
-    menuWidget->addLevel2Tab(0, "Headphones", new CustomWidget("🎧 Headphones Content\n\nBest sellers:\n- Sony WH-1000XM5\n- AirPods Pro\n- Bose QuietComfort"));
-    menuWidget->addLevel2Tab(0, "Cameras", new CustomWidget("📷 Cameras Content\n\nProfessional gear:\n- Sony A7 IV\n- Canon R6\n- Nikon Z8"));
+    menuWidget->addLevel2Tab(0, "Smartphones", lazyContent("📱 Smartphones Content\n\nLatest models available:\n- iPhone 15 Pro\n- Samsung Galaxy S24\n- Google Pixel 8"));
+    menuWidget->addLevel2Tab(0, "Laptops", lazyContent("💻 Laptops Content\n\nTop picks:\n- MacBook Pro M3\n- Dell XPS 15\n- ThinkPad X1 Carbon"));
+    menuWidget->addLevel2Tab(0, "Headphones", lazyContent("🎧 Headphones Content\n\nBest sellers:\n- Sony WH-1000XM5\n- AirPods Pro\n- Bose QuietComfort"));
+    menuWidget->addLevel2Tab(0, "Cameras", lazyContent("📷 Cameras Content\n\nProfessional gear:\n- Sony A7 IV\n- Canon R6\n- Nikon Z8"));
 
     // Add Level 2 tabs for Clothing (index 1)
-    menuWidget->addLevel2Tab(1, "Men", new CustomWidget("👔 Men's Clothing\n\nCategories:\n- Shirts\n- Pants\n- Shoes\n- Accessories"));
-    menuWidget->addLevel2Tab(1, "Women", new CustomWidget("👗 Women's Clothing\n\nCategories:\n- Dresses\n- Tops\n- Skirts\n- Accessories"));
-    menuWidget->addLevel2Tab(1, "Kids", new CustomWidget("👶 Kids Clothing\n\nCategories:\n- Boys\n- Girls\n- Toddlers\n- Babies"));
+    menuWidget->addLevel2Tab(1, "Men", lazyContent("👔 Men's Clothing\n\nCategories:\n- Shirts\n- Pants\n- Shoes\n- Accessories"));
+    menuWidget->addLevel2Tab(1, "Women", lazyContent("👗 Women's Clothing\n\nCategories:\n- Dresses\n- Tops\n- Skirts\n- Accessories"));
+    menuWidget->addLevel2Tab(1, "Kids", lazyContent("👶 Kids Clothing\n\nCategories:\n- Boys\n- Girls\n- Toddlers\n- Babies"));
 
     // Add Level 2 tabs for Books (index 2)
-    menuWidget->addLevel2Tab(2, "Fiction", new CustomWidget("📚 Fiction Books\n\nBestsellers:\n- Mystery\n- Romance\n- Sci-Fi\n- Fantasy"));
-    menuWidget->addLevel2Tab(2, "Non-Fiction", new CustomWidget("📖 Non-Fiction Books\n\nCategories:\n- Biography\n- History\n- Science\n- Self-Help"));
-    menuWidget->addLevel2Tab(2, "Technical", new CustomWidget("💾 Technical Books\n\nPopular topics:\n- Programming\n- AI/ML\n- Cloud Computing\n- Cybersecurity"));
+    menuWidget->addLevel2Tab(2, "Fiction", lazyContent("📚 Fiction Books\n\nBestsellers:\n- Mystery\n- Romance\n- Sci-Fi\n- Fantasy"));
+    menuWidget->addLevel2Tab(2, "Non-Fiction", lazyContent("📖 Non-Fiction Books\n\nCategories:\n- Biography\n- History\n- Science\n- Self-Help"));
+    menuWidget->addLevel2Tab(2, "Technical", lazyContent("💾 Technical Books\n\nPopular topics:\n- Programming\n- AI/ML\n- Cloud Computing\n- Cybersecurity"));
 
     // Add Level 2 tabs for Sports (index 3)
-    menuWidget->addLevel2Tab(3, "Football", new CustomWidget("⚽ Football Equipment\n\nEssentials:\n- Balls\n- Boots\n- Jerseys\n- Shin Guards"));
-    menuWidget->addLevel2Tab(3, "Basketball", new CustomWidget("🏀 Basketball Equipment\n\nEssentials:\n- Balls\n- Shoes\n- Jerseys\n- Hoops"));
-    menuWidget->addLevel2Tab(3, "Tennis", new CustomWidget("🎾 Tennis Equipment\n\nEssentials:\n- Rackets\n- Balls\n- Shoes\n- Bags"));
-    menuWidget->addLevel2Tab(3, "Swimming", new CustomWidget("🏊 Swimming Equipment\n\nEssentials:\n- Swimsuits\n- Goggles\n- Caps\n- Fins"));
+    menuWidget->addLevel2Tab(3, "Football", lazyContent("⚽ Football Equipment\n\nEssentials:\n- Balls\n- Boots\n- Jerseys\n- Shin Guards"));
+    menuWidget->addLevel2Tab(3, "Basketball", lazyContent("🏀 Basketball Equipment\n\nEssentials:\n- Balls\n- Shoes\n- Jerseys\n- Hoops"));
+    menuWidget->addLevel2Tab(3, "Tennis", lazyContent("🎾 Tennis Equipment\n\nEssentials:\n- Rackets\n- Balls\n- Shoes\n- Bags"));
+    menuWidget->addLevel2Tab(3, "Swimming", lazyContent("🏊 Swimming Equipment\n\nEssentials:\n- Swimsuits\n- Goggles\n- Caps\n- Fins"));
 
     // ========================================
     // TEST: Set MenuWidget to MainWidget
@@ -0,0 +1,12 @@
+QT += testlib
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_corebenchmark
+TEMPLATE = app
+
+include(../../src/core.pri)
+
+SOURCES += \
+    tst_corebenchmark.cpp
@@ -0,0 +1,640 @@
+// ========================================
+// BENCHMARK SUITE: widget core
+// ========================================
+// QtTest benchmarks of the MenuWidget, Container and MainWidget
+// operations that scale with the size of the menu: building tabs,
+// content lookup, tab selection, showing a widget in a Container,
+// switching areas, the mean and worst frame time of scrolling a level 2
+// strip of up to 50k tabs (against 16.7 ms for 60 fps), scrolling
+// through a catalog with and without content widget recycling, removing
+// and moving tabs of a live catalog and restoring a saved session, plus
+// resident memory per 1000 items and the cost of a trace span with
+// tracing disabled and enabled.
+//
+// Besides the usual QtTest output, the results are written as JSON
+// (corebenchmark.json, or the file given with -json) so they can be
+// compared across releases:
+//
+//   { "suite": ..., "qtVersion": ..., "timestamp": ...,
+//     "results": [ { "function", "tag", "metric", "value", "iterations" } ] }
+//
+// "value" is per iteration, in the unit of "metric" (e.g.
+// WalltimeMilliseconds, BytesAllocated).
+//
+// Run headless:
+//   QT_QPA_PLATFORM=offscreen ./tst_corebenchmark [-json file] [QtTest options]
+// ========================================
+
+#include <QtTest>
+#include <QApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <QVBoxLayout>
+#include <QXmlStreamReader>
+#include "MainWidget.h"
+#include "MenuWidget.h"
+#include "CustomWidget.h"
+#include "Container.h"
+#include "TabStrip.h"
+#include "MenuModel.h"
+#include "Trace.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+MenuWidget::ContentFactory lazyContent(const QString &text)
+{
+    return [text]() { return new CustomWidget(text); };
+}
+
+// Menu of categoryCount x itemCount lazy items, added in one update
+void fillMenu(MenuWidget &menu, int categoryCount, int itemCount)
+{
+    menu.beginUpdate();
+    for (int i = 0; i < categoryCount; ++i) {
+        menu.addLevel1Tab(QString("Category %1").arg(i));
+        for (int j = 0; j < itemCount; ++j) {
+            QString name = QString("Item %1.%2").arg(i).arg(j);
+            menu.addLevel2Tab(i, name, lazyContent(name));
+        }
+    }
+    menu.endUpdate();
+}
+
+// Resident set size of this process in bytes, -1 where not available
+qint64 residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // "size resident shared ...", in pages of 4K to 64K depending on the
+    // architecture
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (fields.size() < 2 || pageSize <= 0) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * pageSize;
+#else
+    return -1;
+#endif
+}
+
+}
+
+class CoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Runs first, before the other tests leave freed memory to reuse
+    void residentMemoryPer1kItems_data();
+    void residentMemoryPer1kItems();
+
+    void addLevel1Tab_data();
+    void addLevel1Tab();
+
+    void addLevel2Tab_data();
+    void addLevel2Tab();
+
+    void getContentWidget_data();
+    void getContentWidget();
+
+    void setCurrentTabs_data();
+    void setCurrentTabs();
+
+    void containerShow_data();
+    void containerShow();
+
+    void switchToArea_data();
+    void switchToArea();
+
+    void scrollTabStrip_data();
+    void scrollTabStrip();
+
+    void scrollCatalog_data();
+    void scrollCatalog();
+
+    void catalogChurn_data();
+    void catalogChurn();
+
+    void restoreState();
+
+    void traceSpan_data();
+    void traceSpan();
+};
+
+void CoreBenchmark::residentMemoryPer1kItems_data()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void CoreBenchmark::residentMemoryPer1kItems()
+{
+    QFETCH(int, itemCount);
+
+    qint64 before = residentBytes();
+    if (before < 0) {
+        QSKIP("Resident memory is only read from /proc/self/statm");
+    }
+
+    MenuWidget menu;
+    fillMenu(menu, 100, itemCount / 100);
+
+    qint64 after = residentBytes();
+    QTest::setBenchmarkResult(qreal(after - before) / (itemCount / 1000), QTest::BytesAllocated);
+}
+
+void CoreBenchmark::addLevel1Tab_data()
+{
+    QTest::addColumn<int>("categoryCount");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void CoreBenchmark::addLevel1Tab()
+{
+    QFETCH(int, categoryCount);
+
+    QBENCHMARK {
+        MenuWidget menu;
+        for (int i = 0; i < categoryCount; ++i) {
+            menu.addLevel1Tab(QString("Category %1").arg(i));
+        }
+    }
+}
+
+void CoreBenchmark::addLevel2Tab_data()
+{
+    QTest::addColumn<int>("itemCount");
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("1k") << 1000 << false;
+    QTest::newRow("10k") << 10000 << false;
+    QTest::newRow("100k") << 100000 << false;
+    QTest::newRow("100k batched") << 100000 << true;
+}
+
+void CoreBenchmark::addLevel2Tab()
+{
+    QFETCH(int, itemCount);
+    QFETCH(bool, batched);
+
+    QBENCHMARK {
+        MenuWidget menu;
+        menu.addLevel1Tab(QStringLiteral("Category"));
+
+        if (batched) {
+            menu.beginUpdate();
+        }
+        for (int i = 0; i < itemCount; ++i) {
+            QString name = QString("Item %1").arg(i);
+            menu.addLevel2Tab(0, name, lazyContent(name));
+        }
+        if (batched) {
+            menu.endUpdate();
+        }
+    }
+}
+
+void CoreBenchmark::getContentWidget_data()
+{
+    QTest::addColumn<int>("categoryCount");
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("1k items") << 10 << 100;
+    QTest::newRow("100k items") << 100 << 1000;
+}
+
+void CoreBenchmark::getContentWidget()
+{
+    QFETCH(int, categoryCount);
+    QFETCH(int, itemCount);
+
+    MenuWidget menu;
+    fillMenu(menu, categoryCount, itemCount);
+
+    // Build the widgets first, the loop measures the lookup alone
+    const int lookups = 64;
+    for (int i = 0; i < lookups; ++i) {
+        QVERIFY(menu.getContentWidget(i % categoryCount, (i * 37) % itemCount));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < lookups; ++i) {
+            menu.getContentWidget(i % categoryCount, (i * 37) % itemCount);
+        }
+    }
+}
+
+void CoreBenchmark::setCurrentTabs_data()
+{
+    QTest::addColumn<int>("categoryCount");
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("10 x 100") << 10 << 100;
+    QTest::newRow("100 x 1000") << 100 << 1000;
+}
+
+void CoreBenchmark::setCurrentTabs()
+{
+    QFETCH(int, categoryCount);
+    QFETCH(int, itemCount);
+
+    MenuWidget menu;
+    fillMenu(menu, categoryCount, itemCount);
+    menu.resize(800, 200);
+    menu.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&menu));
+
+    int step = 0;
+    QBENCHMARK {
+        menu.setCurrentTabs(step % categoryCount, (step * 37) % itemCount);
+        QCoreApplication::processEvents();
+        ++step;
+    }
+}
+
+void CoreBenchmark::containerShow_data()
+{
+    QTest::addColumn<int>("widgetCount");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+}
+
+void CoreBenchmark::containerShow()
+{
+    QFETCH(int, widgetCount);
+
+    QWidget window;
+    QVBoxLayout *layout = new QVBoxLayout(&window);
+    Container *container = new Container(&window);
+    layout->addWidget(container);
+
+    QVector<CustomWidget*> widgets;
+    for (int i = 0; i < widgetCount; ++i) {
+        CustomWidget *widget = new CustomWidget(QString("Content %1").arg(i), container);
+        container->attach(widget);
+        widgets.append(widget);
+    }
+    window.resize(400, 300);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    int step = 0;
+    QBENCHMARK {
+        container->show(widgets.at((step * 37) % widgetCount));
+        QCoreApplication::processEvents();
+        ++step;
+    }
+}
+
+void CoreBenchmark::switchToArea_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+
+    QTest::newRow("1 x 2") << 1 << 2;
+    QTest::newRow("2 x 2") << 2 << 2;
+    QTest::newRow("3 x 3") << 3 << 3;
+}
+
+void CoreBenchmark::switchToArea()
+{
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+
+    MainWidget mainWidget;
+    mainWidget.setAreaGrid(rows, columns);
+
+    MenuWidget *menu = new MenuWidget();
+    fillMenu(*menu, 10, 100);
+    mainWidget.setMenuWidget(menu);
+
+    mainWidget.resize(1200, 900);
+    mainWidget.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWidget));
+
+    const int areaCount = mainWidget.areaCount();
+    int step = 0;
+    QBENCHMARK {
+        mainWidget.switchToArea(++step % areaCount);
+        QCoreApplication::processEvents();
+    }
+}
+
+void CoreBenchmark::scrollTabStrip_data()
+{
+    QTest::addColumn<int>("itemCount");
+    QTest::addColumn<bool>("worstFrame");
+
+    QTest::newRow("10k mean frame") << 10000 << false;
+    QTest::newRow("10k worst frame") << 10000 << true;
+    QTest::newRow("50k mean frame") << 50000 << false;
+    QTest::newRow("50k worst frame") << 50000 << true;
+}
+
+void CoreBenchmark::scrollTabStrip()
+{
+    QFETCH(int, itemCount);
+    QFETCH(bool, worstFrame);
+
+    MenuModel model;
+    model.appendCategory(QStringLiteral("Category"));
+    QStringList labels;
+    labels.reserve(itemCount);
+    for (int i = 0; i < itemCount; ++i) {
+        labels.append(QString("Item %1").arg(i));
+    }
+    model.appendItems(0, labels);
+
+    TabStrip strip;
+    strip.setModel(&model, model.index(0, 0));
+    strip.resize(800, strip.sizeHint().height());
+    strip.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&strip));
+
+    // Sweep from the first tab to the last one; each frame scrolls half a
+    // page further and paints, so every frame shows tabs that were never
+    // laid out or painted before
+    int frames = 0;
+    qint64 totalNs = 0;
+    qint64 worstNs = 0;
+    QElapsedTimer timer;
+    for (int offset = 0; ; ) {
+        timer.start();
+        offset += strip.width() / 2;
+        strip.setScrollOffset(offset);
+        strip.grab();
+        qint64 elapsed = timer.nsecsElapsed();
+
+        totalNs += elapsed;
+        worstNs = qMax(worstNs, elapsed);
+        ++frames;
+
+        if (strip.scrollOffset() < offset) {
+            break;
+        }
+    }
+
+    // Per frame, to compare with the 16.7 ms of 60 fps
+    qreal frameMs = worstFrame ? worstNs / 1e6 : totalNs / 1e6 / frames;
+    QTest::setBenchmarkResult(frameMs, QTest::WalltimeMilliseconds);
+}
+
+void CoreBenchmark::scrollCatalog_data()
+{
+    QTest::addColumn<int>("poolSize");
+
+    QTest::newRow("one widget per item") << 0;
+    QTest::newRow("recycling, pool of 8") << 8;
+}
+
+void CoreBenchmark::scrollCatalog()
+{
+    QFETCH(int, poolSize);
+
+    // Homogeneous items described as data, as a compiled catalog has
+    const int itemCount = 1000;
+    MenuModel *model = new MenuModel();
+    model->appendCategory(QStringLiteral("Category"));
+    QStringList labels;
+    QStringList contents;
+    for (int i = 0; i < itemCount; ++i) {
+        labels.append(QString("Item %1").arg(i));
+        contents.append(QString("Content %1").arg(i));
+    }
+    model->appendTextItems(0, labels, contents);
+
+    MainWidget mainWidget;
+    MenuWidget *menu = new MenuWidget();
+    model->setParent(menu);
+    menu->setModel(model);
+    menu->setContentRecycling(poolSize);
+    mainWidget.setMenuWidget(menu);
+
+    mainWidget.resize(1200, 900);
+    mainWidget.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&mainWidget));
+
+    int item = 0;
+    QBENCHMARK {
+        menu->activateTabs(0, ++item % itemCount);
+        QCoreApplication::processEvents();
+    }
+
+    // The pool only grows while all of its widgets are on screen
+    if (poolSize > 0) {
+        QVERIFY(menu->recycledContentCount() <= poolSize + mainWidget.areaCount());
+    }
+}
+
+void CoreBenchmark::catalogChurn_data()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("1k items") << 1000;
+    QTest::newRow("100k items") << 100000;
+}
+
+void CoreBenchmark::catalogChurn()
+{
+    QFETCH(int, itemCount);
+
+    MenuWidget menu;
+    fillMenu(menu, 1, itemCount);
+    menu.show();
+
+    // Followed by id through every change below
+    const MenuWidget::TabId watched = menu.level2TabId(0, itemCount / 2);
+    QVERIFY(watched != 0);
+    QVERIFY(menu.getContentWidget(0, itemCount / 2));
+
+    // One move, one removal and one insertion per iteration, the catalog
+    // keeps its size
+    int step = 0;
+    QBENCHMARK {
+        ++step;
+        menu.moveLevel2Tab(0, (step * 7919) % itemCount, (step * 104729) % itemCount);
+
+        int removed = (step * 31) % itemCount;
+        if (menu.level2TabId(0, removed) != watched) {
+            menu.removeLevel2Tab(0, removed);
+            menu.addLevel2Tab(0, QString("Added %1").arg(step), lazyContent(QString::number(step)));
+        }
+    }
+
+    int level1Index = -1;
+    int level2Index = -1;
+    QVERIFY(menu.findTab(watched, &level1Index, &level2Index));
+    QCOMPARE(menu.level2TabId(level1Index, level2Index), watched);
+    QCOMPARE(menu.builtContentCount(), 1);
+}
+
+void CoreBenchmark::restoreState()
+{
+    QByteArray state;
+    {
+        MainWidget mainWidget;
+        MenuWidget *menu = new MenuWidget();
+        fillMenu(*menu, 100, 1000);
+        mainWidget.setMenuWidget(menu);
+        mainWidget.setAreaGrid(2, 2);
+        mainWidget.initializeAreas();
+
+        // Somewhere deep in the catalog
+        for (int area = 0; area < mainWidget.areaCount(); ++area) {
+            mainWidget.switchToArea(area);
+            menu->activateTabs(90 - area, 900 + area);
+        }
+        state = mainWidget.saveState();
+    }
+
+    // Only the visited categories are stored, not all 100
+    QVERIFY(state.size() < 256);
+
+    // A fresh start, as on launch: restore, then show
+    QBENCHMARK {
+        MainWidget mainWidget;
+        MenuWidget *menu = new MenuWidget();
+        fillMenu(*menu, 100, 1000);
+        mainWidget.setMenuWidget(menu);
+
+        QVERIFY(mainWidget.restoreState(state));
+        mainWidget.show();
+        QCoreApplication::processEvents();
+
+        // Only what the areas show was built
+        QCOMPARE(menu->builtContentCount(), mainWidget.areaCount());
+    }
+}
+
+void CoreBenchmark::traceSpan_data()
+{
+    QTest::addColumn<bool>("enabled");
+
+    QTest::newRow("disabled") << false;
+    QTest::newRow("enabled") << true;
+}
+
+void CoreBenchmark::traceSpan()
+{
+    QFETCH(bool, enabled);
+
+    Trace::setEnabled(enabled);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            TRACE_SPAN("CoreBenchmark::traceSpan");
+        }
+    }
+    Trace::setEnabled(false);
+    Trace::clear();
+}
+
+// Copies the benchmark results of a QtTest XML log into a JSON document
+static bool writeJsonResults(const QString &xmlPath, const QString &jsonPath)
+{
+    QFile xmlFile(xmlPath);
+    if (!xmlFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonArray results;
+    QString function;
+    QXmlStreamReader xml(&xmlFile);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            QJsonObject result;
+            result.insert(QStringLiteral("function"), function);
+            result.insert(QStringLiteral("tag"), attributes.value(QLatin1String("tag")).toString());
+            result.insert(QStringLiteral("metric"), attributes.value(QLatin1String("metric")).toString());
+            result.insert(QStringLiteral("value"), attributes.value(QLatin1String("value")).toDouble());
+            result.insert(QStringLiteral("iterations"), attributes.value(QLatin1String("iterations")).toInt());
+            results.append(result);
+        }
+    }
+    if (xml.hasError()) {
+        return false;
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("suite"), QStringLiteral("CoreBenchmark"));
+    root.insert(QStringLiteral("qtVersion"), QLatin1String(qVersion()));
+    root.insert(QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("results"), results);
+
+    QFile jsonFile(jsonPath);
+    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    jsonFile.write(QJsonDocument(root).toJson());
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString jsonPath = QStringLiteral("corebenchmark.json");
+    int jsonOption = arguments.indexOf(QStringLiteral("-json"));
+    if (jsonOption > 0 && jsonOption + 1 < arguments.size()) {
+        jsonPath = arguments.at(jsonOption + 1);
+        arguments.erase(arguments.begin() + jsonOption, arguments.begin() + jsonOption + 2);
+    }
+
+    // QtTest has no JSON logger: log XML to a temporary file as well and
+    // convert it afterwards. Any -o disables the default stdout log.
+    QTemporaryFile xmlLog;
+    if (!xmlLog.open()) {
+        qWarning("Cannot create the temporary benchmark log");
+        return 1;
+    }
+    xmlLog.close();
+
+    if (!arguments.contains(QStringLiteral("-o"))) {
+        arguments << QStringLiteral("-o") << QStringLiteral("-,txt");
+    }
+    arguments << QStringLiteral("-o") << xmlLog.fileName() + QStringLiteral(",xml");
+
+    CoreBenchmark benchmark;
+    int failures = QTest::qExec(&benchmark, arguments);
+
+    if (!writeJsonResults(xmlLog.fileName(), jsonPath)) {
+        qWarning("Cannot write the benchmark results to %s", qPrintable(jsonPath));
+        return failures ? failures : 1;
+    }
+
+    return failures;
+}
+
+#include "tst_corebenchmark.moc"
@@ -0,0 +1,54 @@
+// ========================================
+// menuc: compile a JSON menu definition
+// ========================================
+// Converts a JSON menu into the memory-mappable format read by
+// CompiledMenuModel:
+//
+//   menuc menu.json menu.menu
+//
+// JSON layout:
+//   { "categories": [ { "label": "Category 1",
+//                       "items": [ { "label": "Item 1-1",
+//                                    "content": "Content for Item 1-1" } ] } ] }
+// ========================================
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSaveFile>
+#include <QTextStream>
+#include "CompiledMenuWriter.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    QStringList args = app.arguments();
+    if (args.size() != 3) {
+        err << "usage: menuc <input.json> <output.menu>\n";
+        return 2;
+    }
+
+    QFile input(args.at(1));
+    if (!input.open(QIODevice::ReadOnly)) {
+        err << "menuc: " << args.at(1) << ": " << input.errorString() << "\n";
+        return 1;
+    }
+
+    CompiledMenuWriter writer;
+    if (!writer.addJson(input.readAll())) {
+        err << "menuc: " << args.at(1) << ": " << writer.errorString() << "\n";
+        return 1;
+    }
+
+    // Written to a temporary file first so a running app never maps a partial menu
+    QSaveFile output(args.at(2));
+    if (!output.open(QIODevice::WriteOnly) || !writer.write(&output) || !output.commit()) {
+        err << "menuc: " << args.at(2) << ": " << output.errorString() << "\n";
+        return 1;
+    }
+
+    QTextStream(stdout) << writer.categoryCount() << " categories, "
+                        << writer.itemCount() << " items\n";
+    return 0;
+}
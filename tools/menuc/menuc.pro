@@ -0,0 +1,14 @@
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = menuc
+TEMPLATE = app
+
+include(../../src/core.pri)
+
+# Only the compiled menu writer is linked from the library, which needs
+# nothing but QtCore
+QT -= gui widgets concurrent
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,274 @@
+// ========================================
+// navreplay: replay a navigation log headless
+// ========================================
+// Drives a MainWidget and its MenuWidget from a log written by
+// NavigationRecorder (run the app with MENUWIDGET_RECORD=<file>), under
+// the offscreen platform, and reports the latency of each step: from the
+// selection or area switch until Qt has processed the resulting layout
+// and paint events.
+//
+//   navreplay <log> [options]
+//
+//   --menu <file.menu>   replay over a compiled menu (see tools/menuc)
+//   --catalog <CxI>      or over C categories x I lazy items (100x1000)
+//   --grid <RxC>         area grid (1x2)
+//   --budget <ms>        frame budget (16.7)
+//   --realtime           keep the recorded pauses between steps
+//   --repeat <n>         replay the log n times (1)
+//   --json <file>        also write the results as JSON
+//   --max-p95 <ms>       exit with 1 if p95 is above this, for CI
+// ========================================
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include "MainWidget.h"
+#include "MenuWidget.h"
+#include "CustomWidget.h"
+#include "NavigationRecorder.h"
+#include "CompiledMenuModel.h"
+
+namespace {
+
+struct Options {
+    QString logFile;
+    QString menuFile;
+    int categories = 100;
+    int items = 1000;
+    int rows = 1;
+    int columns = 2;
+    double budgetMs = 16.7;
+    bool realtime = false;
+    int repeat = 1;
+    QString jsonFile;
+    double maxP95Ms = -1;
+};
+
+bool parseSize(const QString &text, int *first, int *second)
+{
+    QStringList parts = text.split(QLatin1Char('x'));
+    if (parts.size() != 2) {
+        return false;
+    }
+
+    bool firstOk = false;
+    bool secondOk = false;
+    *first = parts.at(0).toInt(&firstOk);
+    *second = parts.at(1).toInt(&secondOk);
+    return firstOk && secondOk && *first > 0 && *second > 0;
+}
+
+bool parseOptions(const QStringList &args, Options *options)
+{
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        bool hasValue = i + 1 < args.size();
+        bool ok = true;
+
+        if (arg == QLatin1String("--menu") && hasValue) {
+            options->menuFile = args.at(++i);
+        } else if (arg == QLatin1String("--catalog") && hasValue) {
+            ok = parseSize(args.at(++i), &options->categories, &options->items);
+        } else if (arg == QLatin1String("--grid") && hasValue) {
+            ok = parseSize(args.at(++i), &options->rows, &options->columns);
+        } else if (arg == QLatin1String("--budget") && hasValue) {
+            options->budgetMs = args.at(++i).toDouble(&ok);
+        } else if (arg == QLatin1String("--realtime")) {
+            options->realtime = true;
+        } else if (arg == QLatin1String("--repeat") && hasValue) {
+            options->repeat = args.at(++i).toInt(&ok);
+            ok = ok && options->repeat > 0;
+        } else if (arg == QLatin1String("--json") && hasValue) {
+            options->jsonFile = args.at(++i);
+        } else if (arg == QLatin1String("--max-p95") && hasValue) {
+            options->maxP95Ms = args.at(++i).toDouble(&ok);
+        } else if (!arg.startsWith(QLatin1Char('-')) && options->logFile.isEmpty()) {
+            options->logFile = arg;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+    return !options->logFile.isEmpty();
+}
+
+// Let Qt do the work the step scheduled: layout, polish, paint
+void flushEvents()
+{
+    QCoreApplication::sendPostedEvents();
+    QCoreApplication::processEvents();
+}
+
+// Keep processing events while waiting, as an idle app would
+void waitFor(qint64 msec)
+{
+    if (msec <= 0) {
+        return;
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(int(msec), &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const QVector<double> &sorted, double p)
+{
+    if (sorted.isEmpty()) {
+        return 0;
+    }
+    int rank = int(std::ceil(p / 100.0 * sorted.size()));
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Options options;
+    if (!parseOptions(app.arguments(), &options)) {
+        err << "usage: navreplay <log> [--menu file.menu] [--catalog CxI] [--grid RxC]\n"
+               "                 [--budget ms] [--realtime] [--repeat n] [--json file] [--max-p95 ms]\n";
+        return 2;
+    }
+
+    QVector<NavigationRecorder::Event> events;
+    QString errorString;
+    if (!NavigationRecorder::load(options.logFile, &events, &errorString)) {
+        err << "navreplay: " << options.logFile << ": " << errorString << "\n";
+        return 1;
+    }
+
+    // ========================================
+    // Catalog and widgets
+    // ========================================
+    MainWidget mainWidget;
+    mainWidget.setAreaGrid(options.rows, options.columns);
+
+    MenuWidget *menuWidget = new MenuWidget();
+    if (!options.menuFile.isEmpty()) {
+        CompiledMenuModel *model = new CompiledMenuModel(menuWidget);
+        if (!model->open(options.menuFile)) {
+            err << "navreplay: " << options.menuFile << ": " << model->errorString() << "\n";
+            return 1;
+        }
+        menuWidget->setModel(model);
+    } else {
+        menuWidget->beginUpdate();
+        for (int i = 0; i < options.categories; ++i) {
+            menuWidget->addLevel1Tab(QString("Category %1").arg(i + 1));
+
+            QStringList names;
+            QList<MenuWidget::ContentFactory> factories;
+            for (int j = 0; j < options.items; ++j) {
+                QString name = QString("Item %1-%2").arg(i + 1).arg(j + 1);
+                names.append(name);
+                factories.append([name]() { return new CustomWidget(name); });
+            }
+            menuWidget->addLevel2Tabs(i, names, factories);
+        }
+        menuWidget->endUpdate();
+    }
+    mainWidget.setMenuWidget(menuWidget);
+
+    mainWidget.resize(1200, 900);
+    mainWidget.show();
+    flushEvents();
+
+    // ========================================
+    // Replay
+    // ========================================
+    QVector<double> latencies;
+    latencies.reserve(events.size() * options.repeat);
+    QElapsedTimer stepTimer;
+    QElapsedTimer replayClock;
+
+    for (int pass = 0; pass < options.repeat; ++pass) {
+        replayClock.start();
+        for (const NavigationRecorder::Event &event : events) {
+            if (options.realtime) {
+                waitFor(event.time - replayClock.elapsed());
+            }
+
+            stepTimer.start();
+            if (event.type == NavigationRecorder::Event::AreaSwitch) {
+                mainWidget.switchToArea(event.first);
+            } else {
+                // As the operator's click did
+                menuWidget->activateTabs(event.first, event.second);
+            }
+            flushEvents();
+            latencies.append(stepTimer.nsecsElapsed() / 1e6);
+        }
+    }
+
+    // ========================================
+    // Report
+    // ========================================
+    QVector<double> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+
+    int overBudget = 0;
+    for (double latency : latencies) {
+        if (latency > options.budgetMs) {
+            ++overBudget;
+        }
+    }
+
+    double p50 = percentile(sorted, 50);
+    double p95 = percentile(sorted, 95);
+    double p99 = percentile(sorted, 99);
+    double worst = sorted.isEmpty() ? 0 : sorted.last();
+
+    out << sorted.size() << " steps\n"
+        << "p50  " << p50 << " ms\n"
+        << "p95  " << p95 << " ms\n"
+        << "p99  " << p99 << " ms\n"
+        << "max  " << worst << " ms\n"
+        << overBudget << " frames over the " << options.budgetMs << " ms budget\n";
+
+    if (!options.jsonFile.isEmpty()) {
+        QJsonObject result;
+        result.insert(QStringLiteral("log"), options.logFile);
+        result.insert(QStringLiteral("steps"), sorted.size());
+        result.insert(QStringLiteral("p50Ms"), p50);
+        result.insert(QStringLiteral("p95Ms"), p95);
+        result.insert(QStringLiteral("p99Ms"), p99);
+        result.insert(QStringLiteral("maxMs"), worst);
+        result.insert(QStringLiteral("budgetMs"), options.budgetMs);
+        result.insert(QStringLiteral("overBudget"), overBudget);
+
+        QFile file(options.jsonFile);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "navreplay: " << options.jsonFile << ": " << file.errorString() << "\n";
+            return 1;
+        }
+        file.write(QJsonDocument(result).toJson());
+    }
+
+    if (options.maxP95Ms >= 0 && p95 > options.maxP95Ms) {
+        err << "navreplay: p95 " << p95 << " ms is above " << options.maxP95Ms << " ms\n";
+        return 1;
+    }
+
+    return 0;
+}